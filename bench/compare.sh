@@ -0,0 +1,204 @@
+#!/bin/sh
+#
+# compare.sh - check that two builds of DOC++ write the same output and
+#              compare their speed and memory use
+#
+# Usage: compare.sh REFERENCE CANDIDATE [small|medium|large|huge]
+#
+# Both doc++ binaries are run over the manual in doc/manual and over the
+# generated C++, Java and PHP trees of the given size (small by default),
+# in HTML, TeX, DocBook and DocBook XML mode. The output trees are compared
+# byte by byte; if they differ, they are compared again with the dates
+# DOC++ puts into its output masked. A case passes only if the outputs are
+# equal. Both builds are timed and measured as whole processes, the peak
+# RSS is known with GNU time or BSD `time -l'. The phases are taken from
+# `--stats-json' if the binary knows it.
+#
+# The exit status is 1 if any output differs. The environment variables
+# GENSRC and BENCH_DIR are used as in run.sh, COMPARE_MODES selects the
+# output modes (html tex docbook docbookxml).
+
+if test $# -lt 2; then
+    echo "Usage: $0 REFERENCE CANDIDATE [small|medium|large|huge]" >&2
+    exit 2
+fi
+
+ref=$1
+cand=$2
+size=${3:-small}
+here=`cd \`dirname $0\` && pwd`
+GENSRC=${GENSRC:-./gensrc}
+BENCH_DIR=${BENCH_DIR:-bench-out}
+COMPARE_MODES=${COMPARE_MODES:-"html tex docbook docbookxml"}
+
+case $size in
+    small)	shape="-n 4 -c 25 -m 9" ;;
+    medium)	shape="-n 10 -c 100 -m 9" ;;
+    large)	shape="-n 40 -c 250 -m 9" ;;
+    huge)	shape="-n 100 -c 1000 -m 9" ;;
+    *)		echo "$0: unknown size \`$size'" >&2; exit 2 ;;
+esac
+
+for bin in $ref $cand; do
+    if test ! -x $bin; then
+	echo "$0: \`$bin' is not executable" >&2
+	exit 2
+    fi
+done
+
+# doc++ is run from other directories
+ref=`cd \`dirname $ref\` && pwd`/`basename $ref`
+cand=`cd \`dirname $cand\` && pwd`/`basename $cand`
+
+# the date is the only thing that may change between two runs
+LC_ALL=C
+LANG=C
+TZ=UTC
+export LC_ALL LANG TZ
+
+mkdir -p $BENCH_DIR || exit 2
+work=`cd $BENCH_DIR && pwd`/compare
+rm -rf $work
+mkdir -p $work
+
+for lang in cpp java php; do
+    src=$BENCH_DIR/src-$lang-$size
+    if test ! -f $src/files.lst; then
+	echo "Generating $lang sources ($size)..."
+	$GENSRC -l $lang $shape -o $src > /dev/null || exit 2
+    fi
+done
+srcdir=`cd $BENCH_DIR && pwd`
+
+# both builds are timed and measured the same way, as whole processes; GNU
+# and BSD time give the wall time and the peak RSS, time -p and perl only
+# the wall time, date only to the second
+if /usr/bin/time -f '%e %M' true > /dev/null 2>&1; then
+    timer=gnu
+elif /usr/bin/time -l true > /dev/null 2>&1; then
+    timer=bsd
+    # Darwin gives the RSS in bytes, the BSDs in kilobytes
+    rssunit=1
+    test "`uname`" = Darwin && rssunit=1024
+elif test -x /usr/bin/time; then
+    timer=time
+elif perl -MTime::HiRes -e 1 > /dev/null 2>&1; then
+    timer=perl
+else
+    timer=date
+fi
+
+# run BIN SIDE CASE MODE: runs one doc++ and leaves its output in
+# $work/SIDE/CASE, its wall time and peak RSS in $work/SIDE/CASE.time and,
+# if the binary knows `--stats-json', its phases in $work/SIDE/CASE.json
+run()
+{
+    bin=$1
+    out=$work/$2/$3
+    mkdir -p $out
+    case $4 in
+	html)		modeflags="-d $out" ;;
+	tex)		modeflags="-t -o $out/doc.tex" ;;
+	docbook)	modeflags="-Z -o $out/doc.sgml" ;;
+	docbookxml)	modeflags="-L -o $out/doc.xml" ;;
+    esac
+    case $3 in
+	manual-*)	dir=$here/../doc/manual; input=doc.dxx ;;
+	cpp-*)		dir=$srcdir; input="-I src-cpp-$size/files.lst" ;;
+	java-*)		dir=$srcdir; input="-J -I src-java-$size/files.lst" ;;
+	php-*)		dir=$srcdir; input="-z -I src-php-$size/files.lst" ;;
+    esac
+
+    json=
+    rm -f $out.json
+    if $bin --help 2>&1 | grep -- --stats-json > /dev/null; then
+	json="--stats-json $out.json"
+    fi
+
+    cmd="cd $dir && $bin -g $modeflags $json $input > $out.log 2>&1"
+    rss=
+    case $timer in
+	gnu)
+	    /usr/bin/time -f '%e %M' -o $out.timing sh -c "$cmd"
+	    wall=`tail -1 $out.timing | awk '{ print $1 }'`
+	    rss=`tail -1 $out.timing | awk '{ print $2 }'`
+	    rm -f $out.timing
+	    ;;
+	bsd)
+	    /usr/bin/time -l sh -c "$cmd" 2> $out.timing
+	    wall=`awk '$2 == "real" { print $1 }' $out.timing`
+	    rss=`awk -v unit=$rssunit \
+		'/maximum resident set size/ { printf "%d", $1 / unit }' \
+		$out.timing`
+	    rm -f $out.timing
+	    ;;
+	time)
+	    /usr/bin/time -p sh -c "$cmd" 2> $out.timing
+	    wall=`awk '/^real/ { print $2 }' $out.timing`
+	    rm -f $out.timing
+	    ;;
+	perl)
+	    wall=`perl -MTime::HiRes=time -e \
+		'$t = time; system("sh", "-c", $ARGV[0]); printf "%.3f", time - $t' \
+		"$cmd"`
+	    ;;
+	*)
+	    start=`date +%s`
+	    sh -c "$cmd"
+	    end=`date +%s`
+	    wall=`expr $end - $start`
+	    ;;
+    esac
+
+    echo "${wall:--} ${rss:--}" > $out.time
+}
+
+# mask what strftime("%c") writes, e.g. `Mon Oct 19 12:00:00 2026'
+normalize()
+{
+    rm -rf $2
+    cp -r $1 $2
+    find $2 -type f -print | while read f; do
+	sed -e 's/[A-Z][a-z][a-z] [A-Z][a-z][a-z] [ 0-9][0-9] [0-9][0-9]:[0-9][0-9]:[0-9][0-9] [0-9][0-9][0-9][0-9]/DATE/g' \
+	    $f > $f.tmp && mv $f.tmp $f
+    done
+}
+
+failed=0
+printf "%-22s %9s %9s %7s %10s %10s %7s  %s\n" case ref_s cand_s time \
+    ref_kb cand_kb rss output
+for corpus in manual cpp java php; do
+    for mode in $COMPARE_MODES; do
+	case=$corpus-$mode
+	run $ref ref $case $mode
+	run $cand cand $case $mode
+
+	if diff -r $work/ref/$case $work/cand/$case > /dev/null 2>&1; then
+	    result=identical
+	else
+	    normalize $work/ref/$case $work/norm-ref
+	    normalize $work/cand/$case $work/norm-cand
+	    if diff -r $work/norm-ref $work/norm-cand > $work/$case.diff 2>&1
+	    then
+		result="equal up to dates"
+		rm -f $work/$case.diff
+	    else
+		result="DIFFERENT, see $work/$case.diff"
+		failed=1
+	    fi
+	    rm -rf $work/norm-ref $work/norm-cand
+	fi
+
+	cat $work/ref/$case.time $work/cand/$case.time | tr '\n' ' ' | \
+	    awk -v name=$case -v result="$result" '
+		function delta(a, b) {
+		    if(a == "-" || b == "-" || a == 0)
+			return "-"
+		    return sprintf("%+.1f%%", (b - a) * 100 / a)
+		}
+		{ printf "%-22s %9s %9s %7s %10s %10s %7s  %s\n", name, $1, $3,
+		    delta($1, $3), $2, $4, delta($2, $4), result }'
+    done
+done
+
+exit $failed
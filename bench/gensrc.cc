@@ -0,0 +1,356 @@
+/*
+  gensrc.cc
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this library; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/* Generates a synthetic source tree to benchmark DOC++ with.
+
+   The output only depends on the options, so two runs with the same options
+   give byte for byte the same files. Every namespace (a package in Java, a
+   name prefix in PHP) gets its own directory holding one file per class.
+   A list of all files is written to `files.lst', to be passed to DOC++
+   with `--input'.
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef WIN32
+#include <direct.h>
+#define makedir(a, b) mkdir(a)
+#else
+#define makedir(a, b) mkdir(a, b)
+#endif
+
+enum Language { CXX, JAVA, PHP };
+
+static Language language = CXX;
+static int namespaces = 4;		// -n
+static int classes = 25;		// -c, per namespace
+static int members = 9;			// -m, per class
+static int depth = 3;			// -d, length of inheritance chains
+static int docDensity = 80;		// -p, percentage of documented items
+static int crossRefs = 2;		// -r, per documented item
+static int formulas = 5;		// -f, percentage of items with a formula
+static unsigned long seed = 1;		// -s
+static const char *outDir = "gensrc";	// -o
+
+static FILE *list;
+
+/// A small linear congruential generator, so output is the same everywhere
+static int rnd(int n)
+{
+    seed = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    return n > 0 ? (int)((seed >> 8) % (unsigned long)n) : 0;
+}
+
+static bool chance(int percent)
+{
+    return rnd(100) < percent;
+}
+
+static const char *words[] =
+{
+    "returns", "the", "current", "value", "of", "a", "buffer", "node",
+    "handle", "index", "for", "given", "size", "and", "updates", "state",
+    "list", "table", "entry", "object", "stream", "range", "key", "cache"
+};
+
+static const char *texFormulas[] =
+{
+    "$x_i^2 + y_i^2$",
+    "$\\frac{a}{b}$",
+    "$\\sqrt{n \\log n}$",
+    "$\\sum_{i=0}^{n} a_i$",
+    "$O(n^2)$"
+};
+
+static void className(char *buf, int ns, int cls)
+{
+    if(language == PHP)
+	sprintf(buf, "ns%d_Class%d", ns, cls);
+    else
+	sprintf(buf, "Class%d", cls);
+}
+
+/// Writes a reference to some other class, qualified if it is elsewhere
+static void crossRef(FILE *f, int ns)
+{
+    int other = rnd(namespaces), cls = rnd(classes);
+    char buf[64];
+
+    className(buf, other, cls);
+    if(other == ns || language == PHP)
+	fprintf(f, "%s", buf);
+    else
+	if(language == JAVA)
+	    fprintf(f, "ns%d.%s", other, buf);
+	else
+	    fprintf(f, "ns%d::%s", other, buf);
+}
+
+static void docComment(FILE *f, const char *indent, int ns, bool method)
+{
+    int i, n;
+
+    if(!chance(docDensity))
+	return;
+
+    fprintf(f, "%s/** ", indent);
+    n = 4 + rnd(8);
+    for(i = 0; i < n; i++)
+	fprintf(f, i ? " %s" : "%s", words[rnd(sizeof(words) / sizeof(words[0]))]);
+    fprintf(f, ".\n");
+
+    n = 1 + rnd(3);
+    for(i = 0; i < n; i++)
+	{
+	fprintf(f, "%s    ", indent);
+	for(int j = 0; j < 10; j++)
+	    fprintf(f, j ? " %s" : "%s", words[rnd(sizeof(words) / sizeof(words[0]))]);
+	fprintf(f, ".\n");
+	}
+    if(chance(formulas))
+	fprintf(f, "%s    The cost is %s.\n", indent,
+	    texFormulas[rnd(sizeof(texFormulas) / sizeof(texFormulas[0]))]);
+    if(method)
+	{
+	fprintf(f, "%s    @param a the first %s\n", indent, words[rnd(24)]);
+	fprintf(f, "%s    @param b the second %s\n", indent, words[rnd(24)]);
+	fprintf(f, "%s    @return the new %s\n", indent, words[rnd(24)]);
+	}
+    for(i = 0; i < crossRefs; i++)
+	{
+	fprintf(f, "%s    @see ", indent);
+	crossRef(f, ns);
+	fprintf(f, "\n");
+	}
+    fprintf(f, "%s*/\n", indent);
+}
+
+static void writeClass(FILE *f, int ns, int cls)
+{
+    char name[64], base[64];
+    int i;
+
+    className(name, ns, cls);
+    className(base, ns, cls - 1);
+    bool derived = depth > 0 && cls % (depth + 1) != 0;
+
+    docComment(f, "", ns, false);
+    switch(language)
+	{
+	case CXX:
+	    if(derived)
+		fprintf(f, "class %s : public %s\n{\npublic:\n", name, base);
+	    else
+		fprintf(f, "class %s\n{\npublic:\n", name);
+	    break;
+	case JAVA:
+	    if(derived)
+		fprintf(f, "public class %s extends %s\n{\n", name, base);
+	    else
+		fprintf(f, "public class %s\n{\n", name);
+	    break;
+	case PHP:
+	    if(derived)
+		fprintf(f, "class %s extends %s\n{\n", name, base);
+	    else
+		fprintf(f, "class %s\n{\n", name);
+	    break;
+	}
+
+    for(i = 0; i < members; i++)
+	{
+	bool field = i % 4 == 3;
+
+	docComment(f, "    ", ns, !field);
+	switch(language)
+	    {
+	    case CXX:
+		if(field)
+		    fprintf(f, "    int field%d;\n\n", i);
+		else
+		    fprintf(f, "    virtual int method%d(int a, const %s& b) const;\n\n",
+			i, name);
+		break;
+	    case JAVA:
+		if(field)
+		    fprintf(f, "    public int field%d;\n\n", i);
+		else
+		    fprintf(f, "    public int method%d(int a, %s b)\n    {\n"
+			"\treturn a;\n    }\n\n", i, name);
+		break;
+	    case PHP:
+		if(field)
+		    fprintf(f, "    var $field%d;\n\n", i);
+		else
+		    fprintf(f, "    function method%d($a, $b)\n    {\n"
+			"\treturn $a;\n    }\n\n", i);
+		break;
+	    }
+	}
+    fprintf(f, language == CXX ? "};\n" : "}\n");
+}
+
+static void writeFile(int ns, int cls)
+{
+    static const char *suffix[] = { "h", "java", "php" };
+    char path[1024], name[64];
+
+    className(name, ns, cls);
+    sprintf(path, "%s/ns%d/%s.%s", outDir, ns, name, suffix[language]);
+
+    FILE *f = fopen(path, "w");
+    if(!f)
+	{
+	fprintf(stderr, "gensrc: cannot write `%s'\n", path);
+	exit(1);
+	}
+
+    switch(language)
+	{
+	case CXX:
+	    fprintf(f, "// Generated by gensrc\n\n");
+	    if(depth > 0 && cls % (depth + 1) != 0)
+		fprintf(f, "#include \"Class%d.h\"\n\n", cls - 1);
+	    fprintf(f, "namespace ns%d\n{\n\n", ns);
+	    writeClass(f, ns, cls);
+	    fprintf(f, "\n}\n");
+	    break;
+	case JAVA:
+	    fprintf(f, "// Generated by gensrc\n\npackage ns%d;\n\n", ns);
+	    writeClass(f, ns, cls);
+	    break;
+	case PHP:
+	    fprintf(f, "<?php\n// Generated by gensrc\n\n");
+	    writeClass(f, ns, cls);
+	    fprintf(f, "?>\n");
+	    break;
+	}
+    fclose(f);
+    fprintf(list, "%s\n", path);
+}
+
+static void usage()
+{
+    printf("Usage: gensrc [options]\n"
+	"  -l LANG   language: cpp (default), java or php\n"
+	"  -n N      number of namespaces (%d)\n"
+	"  -c N      classes per namespace (%d)\n"
+	"  -m N      members per class (%d)\n"
+	"  -d N      length of inheritance chains (%d)\n"
+	"  -p PCT    percentage of documented items (%d)\n"
+	"  -r N      @see references per doc comment (%d)\n"
+	"  -f PCT    percentage of doc comments with a formula (%d)\n"
+	"  -s SEED   random seed (%lu)\n"
+	"  -o DIR    output directory (%s)\n",
+	namespaces, classes, members, depth, docDensity, crossRefs, formulas,
+	seed, outDir);
+}
+
+int main(int argc, char **argv)
+{
+    char path[1024];
+    int i, j;
+
+    for(i = 1; i < argc; i++)
+	{
+	if(argv[i][0] != '-' || argv[i][1] == 0 || argv[i][2] != 0 ||
+	    i + 1 >= argc)
+	    {
+	    usage();
+	    return strcmp(argv[i], "-h") == 0 ? 0 : 1;
+	    }
+	const char *arg = argv[++i];
+	switch(argv[i - 1][1])
+	    {
+	    case 'l':
+		if(strcmp(arg, "java") == 0)
+		    language = JAVA;
+		else
+		    if(strcmp(arg, "php") == 0)
+			language = PHP;
+		    else
+			language = CXX;
+		break;
+	    case 'n':
+		namespaces = atoi(arg);
+		break;
+	    case 'c':
+		classes = atoi(arg);
+		break;
+	    case 'm':
+		members = atoi(arg);
+		break;
+	    case 'd':
+		depth = atoi(arg);
+		break;
+	    case 'p':
+		docDensity = atoi(arg);
+		break;
+	    case 'r':
+		crossRefs = atoi(arg);
+		break;
+	    case 'f':
+		formulas = atoi(arg);
+		break;
+	    case 's':
+		seed = strtoul(arg, 0, 10);
+		break;
+	    case 'o':
+		outDir = arg;
+		break;
+	    default:
+		usage();
+		return 1;
+	    }
+	}
+
+    if(makedir(outDir, 0755) != 0 && errno != EEXIST)
+	{
+	fprintf(stderr, "gensrc: cannot create `%s'\n", outDir);
+	return 1;
+	}
+    sprintf(path, "%s/files.lst", outDir);
+    if(!(list = fopen(path, "w")))
+	{
+	fprintf(stderr, "gensrc: cannot write `%s'\n", path);
+	return 1;
+	}
+
+    for(i = 0; i < namespaces; i++)
+	{
+	sprintf(path, "%s/ns%d", outDir, i);
+	if(makedir(path, 0755) != 0 && errno != EEXIST)
+	    {
+	    fprintf(stderr, "gensrc: cannot create `%s'\n", path);
+	    return 1;
+	    }
+	for(j = 0; j < classes; j++)
+	    writeFile(i, j);
+	}
+    fclose(list);
+
+    printf("%d files, about %ld entries\n", namespaces * classes,
+	(long)namespaces * classes * (members + 1));
+    return 0;
+}
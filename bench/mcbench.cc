@@ -0,0 +1,384 @@
+/*
+  mcbench.cc
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this library; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/* Microbenchmarks of the Mc* containers and string primitives.
+
+   Every benchmark reports the time and the number of heap allocations per
+   operation. Allocations are counted by replacing the global operator new
+   and by installing a counting allocator for the containers as
+   #mcAllocator#. The usage patterns follow those of the scanners and of the
+   HTML writer.
+
+   Usage: mcbench [-q] [SCALE]
+
+   SCALE multiplies the number of operations, -q measures the containers as
+   with `doc++ --quick'.
+*/
+
+#include <assert.h>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if !defined(WIN32)
+#include <sys/time.h>
+#endif
+
+#include "McAlloc.h"
+#include "McDArray.h"
+#include "McHashTable.h"
+#include "McSorter.h"
+#include "McString.h"
+#include "McWildMatch.h"
+#include "nametable.h"
+
+static long allocations = 0;
+
+static void *countedMalloc(size_t n)
+{
+    allocations++;
+    return malloc(n);
+}
+
+static void *countedRealloc(void *p, size_t n)
+{
+    allocations++;
+    return realloc(p, n);
+}
+
+static McAllocator countingAllocator = { countedMalloc, countedRealloc, free };
+
+void *operator new(size_t n)
+{
+    allocations++;
+    void *p = malloc(n ? n : 1);
+    if(!p)
+	throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) throw()
+{
+    free(p);
+}
+
+void *operator new[](size_t n)
+{
+    allocations++;
+    void *p = malloc(n ? n : 1);
+    if(!p)
+	throw std::bad_alloc();
+    return p;
+}
+
+void operator delete[](void *p) throw()
+{
+    free(p);
+}
+
+#if __cplusplus >= 201402L
+void operator delete(void *p, size_t) throw()
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) throw()
+{
+    free(p);
+}
+#endif
+
+
+static double now()
+{
+#if !defined(WIN32)
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+bool fastNotSmall = false;	// -q, read by McDArray
+static int scale = 1;
+static volatile long sink;	// keeps results alive
+
+/// Runs #f# and reports time and allocations per operation
+static void report(const char *name, long ops, void (*f)(long))
+{
+    long a = allocations;
+    double t = now();
+
+    f(ops);
+    t = now() - t;
+    a = allocations - a;
+    printf("%-34s %10ld %10.1f %10.3f\n", name, ops, t * 1e9 / ops,
+	(double)a / ops);
+}
+
+static unsigned long seed = 1;
+
+static int rnd(int n)
+{
+    seed = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    return (int)((seed >> 8) % (unsigned long)n);
+}
+
+/// Identifiers as they occur in C++ and Java sources
+static McDArray<char *> identifiers;
+
+static void makeIdentifiers(int n)
+{
+    static const char *prefix[] = { "get", "set", "is", "m_", "make", "find",
+	"Mc", "do", "write", "on" };
+    static const char *word[] = { "Entry", "Name", "Table", "Value", "Size",
+	"Node", "List", "Buffer", "Index", "Class", "String", "Handle", "Item",
+	"File", "Page" };
+    char buf[64];
+
+    identifiers.clear();
+    for(int i = 0; i < n; i++)
+	{
+	sprintf(buf, "%s%s%s%d", prefix[rnd(10)], word[rnd(15)], word[rnd(15)],
+	    i);
+	identifiers.append(strdup(buf));
+	}
+}
+
+/// An index into #identifiers#, skewed towards the front like real lookups
+static int skewed()
+{
+    int n = identifiers.size();
+    int r = rnd(n);
+    return rnd(4) ? r % (n / 16 + 1) : r;
+}
+
+static void stringAppendChar(long ops)
+{
+    McString s;
+
+    for(long i = 0; i < ops; i++)
+	{
+	if((i & 1023) == 0)
+	    s.clear();
+	s += (char)('a' + (i & 15));
+	}
+    sink = s.length();
+}
+
+static void stringAppendWord(long ops)
+{
+    McString s;
+
+    for(long i = 0; i < ops; i++)
+	{
+	if((i & 255) == 0)
+	    s.clear();
+	s += identifiers[(int)(i % identifiers.size())];
+	}
+    sink = s.length();
+}
+
+static void stringTokens(long ops)
+{
+    // a new string per token, as the scanners build `current->name'
+    for(long i = 0; i < ops; i++)
+	{
+	McString s;
+	const char *id = identifiers[(int)(i % identifiers.size())];
+	while(*id)
+	    s += *id++;
+	sink += s.length();
+	}
+}
+
+static void arrayAppend(long ops)
+{
+    McDArray<char *> a;
+
+    for(long i = 0; i < ops; i++)
+	{
+	if((i & 4095) == 0)
+	    a.clear();
+	a.append(identifiers[(int)(i % identifiers.size())]);
+	}
+    sink = a.size();
+}
+
+static void arrayInsertFront(long ops)
+{
+    McDArray<int> a;
+
+    for(long i = 0; i < ops; i++)
+	{
+	if((i & 255) == 0)
+	    a.clear();
+	a.insert(0, 1, (int *)&i);
+	}
+    sink = a.size();
+}
+
+static void hashInsert(long ops)
+{
+    long done = 0;
+
+    while(done < ops)
+	{
+	McHashTable<const char *, int> table(0);
+	for(int i = 0; i < identifiers.size() && done < ops; i++, done++)
+	    table.insert(identifiers[i], i);
+	sink = table.size();
+	}
+}
+
+static McHashTable<const char *, int> *lookupTable;
+
+static void hashLookup(long ops)
+{
+    for(long i = 0; i < ops; i++)
+	sink += lookupTable->lookup(identifiers[skewed()]) != 0;
+}
+
+static void hashLookupMiss(long ops)
+{
+    static const char *misses[] = { "int", "const", "static", "void",
+	"return", "class", "public", "unsigned" };
+
+    for(long i = 0; i < ops; i++)
+	sink += lookupTable->lookup(misses[i & 7]) != 0;
+}
+
+static void nameTableAdd(long ops)
+{
+    long done = 0;
+
+    while(done < ops)
+	{
+	NameTable table;
+	for(int i = 0; i < identifiers.size() && done < ops; i++, done++)
+	    table.add(i, identifiers[i]);
+	sink = table.num();
+	}
+}
+
+static NameTable *lookupNames;
+
+static void nameTableHas(long ops)
+{
+    for(long i = 0; i < ops; i++)
+	sink += lookupNames->has(identifiers[skewed()]);
+}
+
+/// What the TOC writers sort: entries compared by their names
+struct TOCItem
+{
+    const char *name;
+    int number;
+};
+
+class TOCCompare
+{
+public:
+    int operator()(const TOCItem& t1, const TOCItem& t2)
+	{
+	return strcmp(t1.name, t2.name);
+	}
+};
+
+static void sortTOC(long ops)
+{
+    const int n = 256;
+    McDArray<TOCItem> items(n);
+    TOCCompare comp;
+    long done = 0;
+
+    while(done < ops)
+	{
+	for(int i = 0; i < n; i++)
+	    {
+	    items[i].name = identifiers[rnd(identifiers.size())];
+	    items[i].number = i;
+	    }
+	sort((TOCItem *)items, n, comp, 0);
+	done += n;
+	}
+    sink = items[0].number;
+}
+
+static void wildMatch(long ops)
+{
+    static const char *patterns[] = { "*.h*", "*.java", "*.php", "Mc*.h",
+	"*Table?.h" };
+    static const char *suffixes[] = { ".h", ".hh", ".cc", ".java", ".php",
+	".o", "" };
+    static McDArray<char *> files;
+    char buf[80];
+
+    if(files.size() == 0)
+	for(int i = 0; i < identifiers.size(); i++)
+	    {
+	    sprintf(buf, "%s%s", identifiers[i], suffixes[i % 7]);
+	    files.append(strdup(buf));
+	    }
+
+    for(long i = 0; i < ops; i++)
+	sink += mcWildMatch(files[(int)(i % files.size())], patterns[i % 5]);
+}
+
+int main(int argc, char **argv)
+{
+    for(int i = 1; i < argc; i++)
+	if(strcmp(argv[i], "-q") == 0)
+	    fastNotSmall = true;
+	else
+	    scale = atoi(argv[i]) > 0 ? atoi(argv[i]) : 1;
+
+    mcAllocator = &countingAllocator;
+    makeIdentifiers(10000);
+
+    lookupTable = new McHashTable<const char *, int>(0);
+    lookupNames = new NameTable;
+    for(int i = 0; i < identifiers.size(); i++)
+	{
+	lookupTable->insert(identifiers[i], i);
+	lookupNames->add(i, identifiers[i]);
+	}
+
+    long n = 1000000L * scale;
+
+    printf("%-34s %10s %10s %10s\n", "benchmark", "ops", "ns/op", "allocs/op");
+    report("McString += char", 10 * n, stringAppendChar);
+    report("McString += identifier", n, stringAppendWord);
+    report("McString token, char by char", n, stringTokens);
+    report("McDArray append", 10 * n, arrayAppend);
+    report("McDArray insert at front", n / 10, arrayInsertFront);
+    report("McHashTable insert", n, hashInsert);
+    report("McHashTable lookup, hit", 10 * n, hashLookup);
+    report("McHashTable lookup, keyword miss", 10 * n, hashLookupMiss);
+    report("NameTable add", n, nameTableAdd);
+    report("NameTable has", 10 * n, nameTableHas);
+    report("sort TOC entries (per item)", n, sortTOC);
+    report("mcWildMatch on file names", 10 * n, wildMatch);
+    return 0;
+}
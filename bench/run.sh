@@ -0,0 +1,97 @@
+#!/bin/sh
+#
+# run.sh - end-to-end benchmark of DOC++
+#
+# Usage: run.sh [small|medium|large|huge]
+#
+# Generates a synthetic source tree with gensrc for every language, runs
+# DOC++ over it in every output mode with `--stats-json' and prints the
+# time of each phase and the peak RSS. The sizes are roughly 1k, 10k, 100k
+# and 1M entries per language.
+#
+# The following environment variables are honoured:
+#   DOCXX        the doc++ binary to measure (../src/doc++)
+#   GENSRC       the generator (./gensrc)
+#   BENCH_DIR    where sources and results go (./bench-out)
+#   BENCH_LANGS  languages to run (cpp java php)
+#   BENCH_MODES  output modes to run (html tex docbook)
+#   BENCH_FLAGS  extra options for doc++
+
+size=${1:-small}
+here=`dirname $0`
+DOCXX=${DOCXX:-$here/../src/doc++}
+GENSRC=${GENSRC:-./gensrc}
+BENCH_DIR=${BENCH_DIR:-bench-out}
+BENCH_LANGS=${BENCH_LANGS:-"cpp java php"}
+BENCH_MODES=${BENCH_MODES:-"html tex docbook"}
+
+case $size in
+    small)	shape="-n 4 -c 25 -m 9" ;;
+    medium)	shape="-n 10 -c 100 -m 9" ;;
+    large)	shape="-n 40 -c 250 -m 9" ;;
+    huge)	shape="-n 100 -c 1000 -m 9" ;;
+    *)		echo "Usage: $0 [small|medium|large|huge]" >&2; exit 1 ;;
+esac
+
+if test ! -x "$DOCXX"; then
+    echo "$0: no doc++ binary at \`$DOCXX', set DOCXX" >&2
+    exit 1
+fi
+
+mkdir -p $BENCH_DIR/results || exit 1
+summary=$BENCH_DIR/results/$size.txt
+: > $summary
+
+for lang in $BENCH_LANGS; do
+    src=$BENCH_DIR/src-$lang-$size
+    if test ! -f $src/files.lst; then
+	echo "Generating $lang sources ($size)..."
+	$GENSRC -l $lang $shape -o $src || exit 1
+    fi
+
+    case $lang in
+	java)	langflag=-J ;;
+	php)	langflag=-z ;;
+	*)	langflag= ;;
+    esac
+
+    for mode in $BENCH_MODES; do
+	name=$lang-$mode-$size
+	out=$BENCH_DIR/out-$name
+	json=$BENCH_DIR/results/$name.json
+	rm -rf $out
+	mkdir -p $out
+
+	case $mode in
+	    html)	modeflags="-g -d $out" ;;
+	    tex)	modeflags="-t -o $out/doc.tex" ;;
+	    docbook)	modeflags="-Z -o $out/doc.sgml" ;;
+	esac
+
+	echo "Running $name..."
+	rm -f $json
+	$DOCXX $langflag $modeflags $BENCH_FLAGS --stats-json $json \
+	    -I $src/files.lst > $BENCH_DIR/results/$name.log 2>&1
+	if test ! -f $json; then
+	    echo "$name: doc++ failed, see $BENCH_DIR/results/$name.log"
+	    continue
+	fi
+
+	# one line per run: the top level phases, their total and the peak RSS
+	awk -v name=$name '
+	    /"peak_rss_kb"/ { rss = $2; sub(",", "", rss) }
+	    /"depth": 0/ {
+		match($0, /"name": "[^"]*"/)
+		phase = substr($0, RSTART + 9, RLENGTH - 10)
+		match($0, /"wall": [0-9.]*/)
+		wall = substr($0, RSTART + 8, RLENGTH - 8)
+		line = line sprintf(" %s=%.3f", phase, wall)
+		total += wall
+	    }
+	    END { printf "%-24s total=%.3f rss_kb=%s%s\n", name, total, rss, line }
+	' $json >> $summary
+    done
+done
+
+echo
+cat $summary
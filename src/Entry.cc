@@ -28,6 +28,7 @@
 #include <stdlib.h>
 
 #include "doc.h"
+#include "stats.h"
 
 #define max(a, b) ((a) > (b) ? (a) : (b))
 
@@ -66,7 +67,7 @@ static Entry *cache_entry[MAX_CACHE];
 #define worthDoing(m) !m->general
 
 void makeSubLists(Entry *rt);
-Entry *findJavaPackage(McString n, Entry *root, Entry *p = 0);
+Entry *findJavaPackage(McString n, Entry *p);
 Entry *findJavaClass(McString n, Entry *root);
 bool isIt(const McString& n, const Entry *m);
 static McString* get1RefName(McString &str, int start, int end);
@@ -77,6 +78,7 @@ bool equalArgs(McString const &a, McString const &b);
 bool equalSignature(Entry *a, Entry *b);
 Entry *lookupEntryBySignature(Entry *group, Entry *model);
 bool hasDocumentation(Entry const *entry);
+
 void mergeDocumentation(Entry *original, Entry *ccentry);
 bool mergeEntry(Entry *ccentry);
 void mergeEntries(Entry *root);
@@ -94,6 +96,7 @@ Entry::Entry()
 {
     static int n = 1;
 
+    docStats.entries++;
     number = n++;
     subnumber = 0;
 
@@ -101,8 +104,7 @@ Entry::Entry()
     section       = EMPTY_SEC;
     file	  = _("No file");
     parent        = 0;
-    next          = 0;
-    sub           = 0;
+    sorted        = false;
     ownPage       = 0;
     override      = 0;
 
@@ -113,34 +115,61 @@ Entry::Entry()
     hmemo         = 0;
     hsee          = 0;
     hdoc          = 0;
+    ext           = 0;
     line          = 0;
     general	  = 0;
     pureVirtual	  = false;
     fromUnknownPackage = false;
     docify = !onlyDocs;
+    program.setTag(MC_TAG_SCANNER);
+    body	  = 0;
+    bodyLength	  = 0;
+}
+
+Entry::~Entry()
+{
+    delete ext;
+}
+
+const EntryExtra Entry::noExtra;
+
+EntryExtra::~EntryExtra()
+{
+    if(inherited)
+	freeInheritedMembers(inherited);
+    if(graph)
+	freeClassGraphCache(graph);
+}
+
+EntryExtra& Entry::extra()
+{
+    if(!ext)
+	ext = new EntryExtra;
+    return *ext;
 }
 
 void Entry::addBaseClass(Entry *base, PROTECTION state)
 {
     Entry *tmp2 = this;
+    EntryExtra& x = extra();
 
     if(state == PUBL)
 	{
-	pubBaseclasses.append(base);
-	base->pubChilds.insert(0, 1, &tmp2);
+	x.pubBaseclasses.append(base);
+	base->extra().pubChilds.insert(0, 1, &tmp2);
 	}
     else
 	if(state == PROT)
 	    {
-	    proBaseclasses.append(base);
-	    base->proChilds.insert(0, 1, &tmp2);
+	    x.proBaseclasses.append(base);
+	    base->extra().proChilds.insert(0, 1, &tmp2);
 	    }
 	else
 	    {
-	    priBaseclasses.append(base);
-	    base->priChilds.insert(0, 1, &tmp2);
+	    x.priBaseclasses.append(base);
+	    base->extra().priChilds.insert(0, 1, &tmp2);
 	    }
-    baseclasses.append(base);
+    x.baseclasses.append(base);
 }
 
 void Entry::addBaseClass(const char *classname, PROTECTION state)
@@ -167,27 +196,22 @@ void Entry::addBaseClass(const char *classname, PROTECTION state)
 	str = new McString(classname);
 
 	if(state == PUBL)
-	    otherPubBaseclasses.append(str);
+	    extra().otherPubBaseclasses.append(str);
 	else
 	    if(state == PROT)
-		otherProBaseclasses.append(str);
+		extra().otherProBaseclasses.append(str);
 	    else 
-		otherPriBaseclasses.append(str);
+		extra().otherPriBaseclasses.append(str);
 	}
 }
 
 void Entry::addSubEntry(Entry *current)
 {
-    int	i = 1;
-    Entry **e = &sub;
-
-    sublist.append(current);
-    for(; *e; e = &((*e)->next), ++i)
-	;
-    *e = current;
+    subEntries.append(current);
+    if(sorted)
+	sortedSubs.append(current);
     current->parent = this;
-    current->next = 0;
-    current->subnumber = i;
+    current->subnumber = subEntries.size();
     current->makeFullName();
 }
 
@@ -200,6 +224,8 @@ void Entry::clear()
     memo.clear();
     doc.clear();
     program.clear();
+    body = 0;
+    bodyLength = 0;
 }
 
 void Entry::dump(FILE *foo, bool recursive)
@@ -210,7 +236,7 @@ void Entry::dump(FILE *foo, bool recursive)
     fprintf(foo, "--------------------------Start-%p-----------------------------\n",
 	this);
     fprintf(foo, "section %d protection `%c'\n", section, protection);
-    fprintf(foo, "parent %p next %p sub %p\n", parent, next, sub);
+    fprintf(foo, "parent %p subEntries %d\n", parent, subEntries.size());
     fprintf(foo, "type `%s'\n", type.c_str());
     fprintf(foo, "name `%s'\n", name.c_str());
     fprintf(foo, "args `%s'\n", args.c_str());
@@ -218,23 +244,24 @@ void Entry::dump(FILE *foo, bool recursive)
     fprintf(foo, "doc `%s'\n", doc.c_str());
     fprintf(foo, "file `%s'\n", file.c_str());
     fprintf(foo, "fullName `%s'\n", fullName.c_str());
-    fprintf(foo, "author `%s' version `%s'\n", author.c_str(),
-	version.c_str());
+    const EntryExtra& x = constExtra();
+    fprintf(foo, "author `%s' version `%s'\n", x.author.c_str(),
+	x.version.c_str());
 
-    if(see.size())
+    if(x.see.size())
         fprintf(foo, "see:\n");
-    for(i = 0; i < see.size(); i++)
-	fprintf(foo, "    `%s'\n", see[i]->c_str());
+    for(i = 0; i < x.see.size(); i++)
+	fprintf(foo, "    `%s'\n", x.see[i]->c_str());
 
-    if(param.size())
+    if(x.param.size())
         fprintf(foo, "param:\n");
-    for(i = 0; i < param.size(); i++)
-	fprintf(foo, "    `%s'\n", param[i]->c_str());
+    for(i = 0; i < x.param.size(); i++)
+	fprintf(foo, "    `%s'\n", x.param[i]->c_str());
 
-    if(exception.size())
+    if(x.exception.size())
 	fprintf(foo, "exception:\n");
-    for(i = 0; i < exception.size(); i++)
-	fprintf(foo, "    `%s'\n", exception[i]->c_str());
+    for(i = 0; i < x.exception.size(); i++)
+	fprintf(foo, "    `%s'\n", x.exception[i]->c_str());
 
     if(htype)
 	fprintf(foo, "htype `%s'", htype);
@@ -254,14 +281,14 @@ void Entry::dump(FILE *foo, bool recursive)
 	fileName.c_str(), line, general, ownPage);
     fprintf(foo, "number %d subnumber %d\n", number, subnumber);
 
-    if(sublist.size())
+    if(sublist().size())
 	{
 	fprintf(foo, "sublist:\n");
-	for(i = 0; i < sublist.size(); i++)
+	for(i = 0; i < sublist().size(); i++)
 	if(recursive)
-	    sublist[i]->dump(foo, recursive);
+	    sublist()[i]->dump(foo, recursive);
 	else
-	    fprintf(foo, "        `%s'\n", sublist[i]->name.c_str());
+	    fprintf(foo, "        `%s'\n", sublist()[i]->name.c_str());
 	}
 
     fprintf(foo,"----------------------------End-%p-----------------------------\n",
@@ -304,16 +331,16 @@ Entry *Entry::findSub(const McString& name, int first, int last)
     if(last - first < 4)	// I assume this is to catch different adjacent duplicates
 	{
 	for(i = first + 1; i <= last - 1; i++)
-	    if(isIt(name, sublist[i]))
-		return sublist[i];
+	    if(isIt(name, sublist()[i]))
+		return sublist()[i];
         return 0;
 	}
 
     int n = (first + last) / 2;
-    int result = strcmp(name.c_str(), sublist[n]->name.c_str());
+    int result = strcmp(name.c_str(), sublist()[n]->name.c_str());
 
     if(result == 0)
-	return sublist[n];
+	return sublist()[n];
     if(result > 0)
 	return findSub(name, n, last);
 
@@ -331,35 +358,35 @@ Entry *Entry::findSub(const McString& n)
 
 // For some reason, the binary search fails, so let's fall down to a simple
 // linear search, just to be safe
-    for(i = 0; i < sublist.size(); i++)
-	if(isIt(n, sublist[i]))
-	    return sublist[i];
+    for(i = 0; i < sublist().size(); i++)
+	if(isIt(n, sublist()[i]))
+	    return sublist()[i];
 
 /*
-    if(sublist.size())
+    if(sublist().size())
 	{
-	max = sublist.size() - 1;
-	if(isIt(name, sublist[0]))
-	    return sublist[0];
-	if(isIt(name, sublist[max]))
-	    return sublist[max];
+	max = sublist().size() - 1;
+	if(isIt(name, sublist()[0]))
+	    return sublist()[0];
+	if(isIt(name, sublist()[max]))
+	    return sublist()[max];
 	Entry *found = findSub(name, 0, max);
 	if(found)
 	    return found;
 	}
 */
 
-    for(i = sublist.size(); i-- > 0; )
-	if(sublist[i]->sub)
+    for(i = sublist().size(); i-- > 0; )
+	if(sublist()[i]->subEntries.size())
 	    {
-	    Entry *found = sublist[i]->findSub(n);
+	    Entry *found = sublist()[i]->findSub(n);
 	    if(found)
 		return found;
 	    }
 
-    for(i = 0; i < sublist.size(); i++)
-	if(worthDoing(sublist[i]) && n == sublist[i]->name)
-		return sublist[i];
+    for(i = 0; i < sublist().size(); i++)
+	if(worthDoing(sublist()[i]) && n == sublist()[i]->name)
+		return sublist()[i];
 
     return 0;
 }
@@ -388,6 +415,7 @@ bool Entry::isClass()
 
 void Entry::makeFullName(McString &n)
 {
+    const McDArray<McString*>& import = constExtra().import;
     int i, p, ri;
 
 #ifdef DEBUG
@@ -583,8 +611,11 @@ void Entry::makeFullName()
 
 void Entry::makeRefs()
 {
+    const McDArray<McString*>& implements = constExtra().implements;
+    const McDArray<McString*>& extends = constExtra().extends;
     McString tmp;
     int i;
+    double start = fileReport ? statsClock() : 0;
 
     if(language == LANG_JAVA)
 	{
@@ -618,50 +649,33 @@ void Entry::makeRefs()
 	    if((section & CLASS_SEC) || (section & INTERFACE_SEC))
 		findBases();
 
-    for(i = 0; i < sublist.size(); ++i)
-	sublist[i]->makeRefs();
+    if(fileReport && file.length() > 0)
+	fileCost(file.c_str())->refs += statsClock() - start;
+
+    for(i = 0; i < sublist().size(); ++i)
+	sublist()[i]->makeRefs();
 }
 
 void Entry::makeSubList()
 {
     Entry *tmp;
-    int i = 0;
+    int i, j;
 
-    sublist.clear();
-    for(tmp = sub; tmp; tmp = tmp->next)
-	++i;
-
-    if(i)
+    sortedSubs.clear();
+    sortedSubs.remax(subEntries.size());
+    for(j = 0; j < subEntries.size(); j++)
 	{
-	sublist.remax(i);
-	for(tmp = sub; tmp; tmp = tmp->next)
+	tmp = subEntries[j];
+	sortedSubs.append((Entry *)0);
+	for(i = sortedSubs.size() - 1; i > 0; --i)
 	    {
-	    sublist.append((Entry *)0);
-	    for(i = sublist.size() - 1; i > 0; --i)
-		{
-		if(sublist[i - 1]->name <= tmp->name)
-		    break;
-		sublist[i] = sublist[i - 1];
-		}
-	    sublist[i] = tmp;
+	    if(sortedSubs[i - 1]->name <= tmp->name)
+		break;
+	    sortedSubs[i] = sortedSubs[i - 1];
 	    }
-
-	/* the sublist items are sorted, but there seem to be rather
-	   lots of accesses just by traversing via tmp->next, so it's
-	   a quick fix to sort the tmp-entries themselves... */
-
-	/* now everything is sorted out, so let's comment out the code. This
-	   could be useful, for example, to make the `--sort' option usable
-	   for any output format, not only for HTML
-	*/
-/*
-	for(i = 0; i < sublist.size() - 1; i++)
-	    sublist[i]->next = sublist[i + 1];
-
-	sublist[i]->next = (Entry *)0;
-	sub = sublist[0];
-*/
+	sortedSubs[i] = tmp;
 	}
+    sorted = true;
 }
 
 Entry *Entry::newSubEntry()
@@ -675,23 +689,20 @@ Entry *Entry::newSubEntry()
 
 void Entry::removeSub(Entry *e)
 {
-    Entry *tmp;
     int i;
 
-    for(i = 0; i < sublist.size(); i++)
-	if(sublist[i] == e)
+    for(i = 0; i < subEntries.size(); i++)
+	if(subEntries[i] == e)
 	    {
-	    sublist.remove(i);
+	    subEntries.remove(i);
 	    break;
 	    }
 
-    if(sub == e)
-	sub = e->next;
-    else
-	for(tmp = sub; tmp->next; tmp = tmp->next)
-	    if(tmp->next == e)
+    if(sorted)
+	for(i = 0; i < sortedSubs.size(); i++)
+	    if(sortedSubs[i] == e)
 		{
-		tmp->next = e->next;
+		sortedSubs.remove(i);
 		break;
 		}
 }
@@ -765,37 +776,43 @@ void setupLanguageHash()
 	}
 }
 
+void entryTableStats()
+{
+    statsTable("namespaces", namespace_roots.size(), namespace_roots.buckets());
+    if(cxxtable)
+	statsTable("C++ keywords", cxxtable->size(), cxxtable->buckets());
+    if(javatable)
+	statsTable("Java keywords", javatable->size(), javatable->buckets());
+}
+
 void makeSubLists(Entry *rt)
 {
     int i;
 
     rt->makeSubList();
-    for(i = rt->sublist.size(); --i >= 0; )
-	makeSubLists(rt->sublist[i]);
+    for(i = rt->sublist().size(); --i >= 0; )
+	makeSubLists(rt->sublist()[i]);
 }
 
-Entry *findJavaPackage(McString n, Entry *root, Entry *p)
+Entry *findJavaPackage(McString n, Entry *p)
 {
     Entry *tmp, *newPackage, *result = 0;
-    int i = n.index('.'), j;
+    int i = n.index('.'), j, k;
     McString *pkgName;
 
-    if(!root || language == LANG_PHP)
+    if(!p || p->subEntries.size() == 0 || language == LANG_PHP)
 	return 0;
 
-    if(root->section == EMPTY_SEC)
-	{
-	p = root;
-	root = root->sub;
-	}
-
-    if((root->section != PACKAGE_SEC) && (root->section != EMPTY_SEC) &&
-	!(root->section & CLASS_SEC))
+    tmp = p->subEntries[0];
+    if((tmp->section != PACKAGE_SEC) && (tmp->section != EMPTY_SEC) &&
+	!(tmp->section & CLASS_SEC))
 	return 0;
 
     if(i > -1)
 	{
-	for(tmp = root; tmp && !result; tmp = tmp->next)
+	for(k = 0; k < p->subEntries.size() && !result; k++)
+	    {
+	    tmp = p->subEntries[k];
 	    if((tmp->section == PACKAGE_SEC) || (tmp->section & CLASS_SEC))
 		{
 		i = tmp->name.length();
@@ -806,21 +823,25 @@ Entry *findJavaPackage(McString n, Entry *root, Entry *p)
 
 		    if(tmp->name == *pkgName)
 			{
-		    	n.remove(0, i + 1);
+			n.remove(0, i + 1);
 
-		    	if(n.length() < 1)
+			if(n.length() < 1)
 			    result = tmp;
-		    	else
-	    		    result = findJavaPackage(n, tmp->sub, tmp);
+			else
+	    		    result = findJavaPackage(n, tmp);
 			}
 		    }
 		}
+	    }
     	}
     else
-	for(tmp = root; tmp && !result; tmp = tmp->next)
+	for(k = 0; k < p->subEntries.size() && !result; k++)
+	    {
+	    tmp = p->subEntries[k];
 	    if((tmp->section == PACKAGE_SEC) || (tmp->section & CLASS_SEC))
 		if(tmp->name == n)
 		    result = tmp;
+	    }
 
     if(!result)
 	{
@@ -870,10 +891,13 @@ Entry *findJavaClass(McString n, Entry *root)
 	if(i != -1)
 	    n.remove(0, i + 1);
 
-	for(tmp = pkg->sub; tmp && (result == NULL); tmp = tmp->next)
+	for(i = 0; i < pkg->subEntries.size() && result == NULL; i++)
+	    {
+	    tmp = pkg->subEntries[i];
 	    if((tmp->section & CLASS_SEC) || (tmp->section & INTERFACE_SEC))
 		if(tmp->name == n)
 		    result = tmp;
+	    }
 
 	if(!result)
 	    {
@@ -1051,34 +1075,59 @@ bool equalSignature(Entry *a, Entry *b)
     return true;
 }
 
+/* Looks for #model# below #level[first]#, then among #level[first]# and the
+   entries following it in #level#.
+*/
+static Entry *lookupSignature(const McDArray<Entry*>& level, int first,
+    Entry *model)
+{
+    Entry *result, *group = level[first];
+    int i;
+
+    for(i = 0; i < group->subEntries.size(); i++)
+	if((result = lookupSignature(group->subEntries, i, model)))
+	    return result;
+    for(i = first; i < level.size(); i++)
+	if(equalSignature(level[i], model) && level[i] != model)
+	    return level[i];
+
+    return 0;
+}
+
 Entry *lookupEntryBySignature(Entry *group, Entry *model)
 {
-    Entry *result, *index = group;
+    Entry *result;
     int i;
 
-    for(i = 0; i < group->sublist.size(); i++)
-	if((result = lookupEntryBySignature(group->sublist[i], model)))
+    if(group->parent)
+	for(i = 0; i < group->parent->subEntries.size(); i++)
+	    if(group->parent->subEntries[i] == group)
+		return lookupSignature(group->parent->subEntries, i, model);
+
+    for(i = 0; i < group->subEntries.size(); i++)
+	if((result = lookupSignature(group->subEntries, i, model)))
 	    return result;
-    for(; index; index = index->next)
-	if(equalSignature(index, model) && index != model)
-	    return index;
+    if(equalSignature(group, model) && group != model)
+	return group;
 
     return 0;
 }
 
 bool hasDocumentation(Entry const *entry)
 {
+    const EntryExtra& x = entry->constExtra();
+
     return(entry->memo.length() > 0 ||
 	entry->doc.length() > 0 ||
-	entry->param.size() > 0 ||
-	entry->exception.size() > 0 ||
-	entry->retrn.size() > 0 ||
-	entry->see.size() > 0 ||
-	entry->field.size() > 0 ||
-	entry->precondition.size() > 0 ||
-	entry->postcondition.size() > 0 ||
-	entry->invariant.size() > 0 ||
-	entry->friends.size() > 0);
+	x.param.size() > 0 ||
+	x.exception.size() > 0 ||
+	x.retrn.size() > 0 ||
+	x.see.size() > 0 ||
+	x.field.size() > 0 ||
+	x.precondition.size() > 0 ||
+	x.postcondition.size() > 0 ||
+	x.invariant.size() > 0 ||
+	x.friends.size() > 0);
 }
 
 void mergeDocumentation(Entry *original, Entry *ccentry)
@@ -1094,35 +1143,41 @@ void mergeDocumentation(Entry *original, Entry *ccentry)
     original->memo += ccentry->memo;
     original->doc += ccentry->doc;
 
-    for(i = 0; i < ccentry->param.size(); i++)
-	original->param.append(new McString(*(ccentry->param[i])));
+    if(ccentry->hasExtra())
+	{
+	const EntryExtra& from = ccentry->constExtra();
+	EntryExtra& to = original->extra();
 
-    for(i = 0; i < ccentry->exception.size(); i++)
-	original->exception.append(new McString(*(ccentry->exception[i])));
+	for(i = 0; i < from.param.size(); i++)
+	    to.param.append(new McString(*(from.param[i])));
 
-    for(i = 0; i < ccentry->retrn.size(); i++)
-	original->retrn.append(new McString(*(ccentry->retrn[i])));
+	for(i = 0; i < from.exception.size(); i++)
+	    to.exception.append(new McString(*(from.exception[i])));
 
-    for(i = 0; i < ccentry->see.size(); i++)
-	original->see.append(new McString(*(ccentry->see[i])));
+	for(i = 0; i < from.retrn.size(); i++)
+	    to.retrn.append(new McString(*(from.retrn[i])));
 
-    for(i = 0; i < ccentry->field.size(); i++)
-	original->field.append(new McString(*(ccentry->field[i])));
+	for(i = 0; i < from.see.size(); i++)
+	    to.see.append(new McString(*(from.see[i])));
 
-    for(i = 0; i < ccentry->precondition.size(); i++)
-	original->precondition.append(new McString(*(ccentry->precondition[i])));
+	for(i = 0; i < from.field.size(); i++)
+	    to.field.append(new McString(*(from.field[i])));
 
-    for(i = 0; i < ccentry->postcondition.size(); i++)
-	original->postcondition.append(new McString(*(ccentry->postcondition[i])));
+	for(i = 0; i < from.precondition.size(); i++)
+	    to.precondition.append(new McString(*(from.precondition[i])));
 
-    for(i = 0; i < ccentry->invariant.size(); i++)
-	original->invariant.append(new McString(*(ccentry->invariant[i])));
+	for(i = 0; i < from.postcondition.size(); i++)
+	    to.postcondition.append(new McString(*(from.postcondition[i])));
 
-    for(i = 0; i < ccentry->friends.size(); i++)
-	original->friends.append(new McString(*(ccentry->friends[i])));
+	for(i = 0; i < from.invariant.size(); i++)
+	    to.invariant.append(new McString(*(from.invariant[i])));
 
-    for(i = 0; i < ccentry->sublist.size(); i++)
-	original->addSubEntry(ccentry->sublist[i]);
+	for(i = 0; i < from.friends.size(); i++)
+	    to.friends.append(new McString(*(from.friends[i])));
+	}
+
+    for(i = 0; i < ccentry->sublist().size(); i++)
+	original->addSubEntry(ccentry->sublist()[i]);
 }
 
 bool mergeEntry(Entry *ccentry)
@@ -1195,11 +1250,11 @@ void mergeEntries(Entry *root)
 {
     int i;
 
-    for(i = 0; i < root->sublist.size(); i++)
+    for(i = 0; i < root->sublist().size(); i++)
 	{
-	if(root->sublist[i]->sub)
-	    mergeEntries(root->sublist[i]);
-	if(mergeEntry(root->sublist[i]))
+	if(root->sublist()[i]->subEntries.size())
+	    mergeEntries(root->sublist()[i]);
+	if(mergeEntry(root->sublist()[i]))
 	    i--;
 	}
 }
@@ -1237,6 +1292,7 @@ Entry *searchRefEntry(McString &name, Entry *entry)
     if(entry == NULL || entry->general)
 	return 0;
 
+    docStats.refSearches++;
     if(language == LANG_JAVA && name.index('.') >= 0)
 	{
 	result = findJavaClass(name, root);
@@ -1270,11 +1326,17 @@ Entry *searchRefEntry(McString &name, Entry *entry)
     if(fastNotSmall)				// Actualy use the cache :-)
 	for(lp = 0; lp < MAX_CACHE; lp++)
 	    if(cache_entry[lp] && isIt(name, cache_entry[lp]))
+		{
+		docStats.refCacheHits++;
 		return cache_entry[lp];		// Don't re-enter it (probably best)
+		}
     	    else
 		if(cache_name[lp])
 		    if(strcmp(name.c_str(), cache_name[lp]) == 0)
+			{
+			docStats.refCacheHits++;
 			return 0;
+			}
     if(cache_name[cache_pos])
 	free(cache_name[cache_pos]);
     cache_name[cache_pos] = 0;
@@ -1287,18 +1349,18 @@ Entry *searchRefEntry(McString &name, Entry *entry)
 	return(cache_entry[cache_pos++] = tmp);
 
     // Otherwise search in parent classes
-    for(i = 0; i < rot->pubBaseclasses.size(); i++)
+    for(i = 0; i < rot->constExtra().pubBaseclasses.size(); i++)
 	{
-	entry = searchRefEntry(name, rot->pubBaseclasses[i]);
+	entry = searchRefEntry(name, rot->constExtra().pubBaseclasses[i]);
 	if(cache_pos >= MAX_CACHE)
 	    cache_pos = 0;
 	if(entry)
 	    return(cache_entry[cache_pos++] = entry);
 	}
 
-    for(i = 0; i < rot->proBaseclasses.size(); i++)
+    for(i = 0; i < rot->constExtra().proBaseclasses.size(); i++)
 	{
-	entry = searchRefEntry(name, rot->proBaseclasses[i]);
+	entry = searchRefEntry(name, rot->constExtra().proBaseclasses[i]);
 	if(cache_pos >= MAX_CACHE)
 	    cache_pos = 0;
 	if(entry)
@@ -1375,18 +1437,19 @@ Entry *getRefEntry(McString &name, Entry *entry)
     return result;
 }
 
-Entry *findEntry(Entry *start, const char *fullName, unsigned short section)
+Entry *findEntry(Entry *parent, const char *fullName, unsigned short section)
 {
     Entry *result, *find;
+    int i;
 
-    for(find = start; find; find = find->next)
+    for(i = 0; i < parent->subEntries.size(); i++)
 	{
+	find = parent->subEntries[i];
 	if(strcmp(find->fullName.c_str(), fullName) == 0)
 	    if(section == 0 || (find->section & section))
 		return find;
-	if(find->sub)
-	    if((result = findEntry(find->sub, fullName, section)))
-		return result;
+	if((result = findEntry(find, fullName, section)))
+	    return result;
 	}
 
     return 0;
@@ -1394,109 +1457,109 @@ Entry *findEntry(Entry *start, const char *fullName, unsigned short section)
 
 int getNumChildren(Entry *tp)
 {
-    Entry *tmp = tp;
-    int num = 0;
-
-    for(tmp = tp->sub; tmp; tmp = tmp->next)
-	num++;
-
-    return num;
+    return tp->subEntries.size();
 }
 
 void checkPackages(Entry *tp)
 {
-    Entry *tmp = tp, *child, *tmp2, *tmp3;
+    Entry *tmp = tp, *child, *tmp2;
     McString newName;
+    int i;
 
-    for(tmp = tp; tmp; tmp = tmp->next)
-	{
-	if(tmp->sub)
-	    checkPackages(tmp->sub);
+    for(i = 0; i < tp->subEntries.size(); i++)
+	checkPackages(tp->subEntries[i]);
 
-	if(MAKE_DOC(tmp))
-	    if((tmp->section == PACKAGE_SEC) && (getNumChildren(tmp) == 1))
-		{
-		child = tmp->sub;
+    if(MAKE_DOC(tmp))
+	if((tmp->section == PACKAGE_SEC) && (getNumChildren(tmp) == 1))
+	    {
+	    child = tmp->subEntries[0];
 
-		if(child->section == PACKAGE_SEC)
+	    if(child->section == PACKAGE_SEC)
+		{
+		newName.clear();
+		newName += tmp->name;
+		newName += "." + child->name;
+
+		tmp2 = child;
+		tmp2->parent = tmp->parent;
+
+		for(i = 0; i < tmp2->subEntries.size(); i++)
+		    tmp2->subEntries[i]->parent = tmp;
+
+		tmp->section = tmp2->section;
+		tmp->general = tmp2->general;
+		tmp->protection = tmp2->protection;
+		tmp->ownPage = tmp2->ownPage;
+		tmp->subEntries = tmp2->subEntries;
+		tmp->type = tmp2->type;
+		tmp->name = newName;
+		tmp->args = tmp2->args;
+		tmp->memo = tmp2->memo;
+		tmp->doc = tmp2->doc;
+		tmp->program = tmp2->program;
+		tmp->body = tmp2->body;
+		tmp->bodyLength = tmp2->bodyLength;
+		if(tmp2->hasExtra() || tmp->hasExtra())
 		    {
-		    newName.clear();
-		    newName += tmp->name;
-		    newName += "." + (tmp->sub)->name;
-
-		    tmp2 = tmp->sub;
-		    tmp2->parent = tmp->parent;
-
-		    for(tmp3 = tmp2->sub; tmp3; tmp3 = tmp3->next)
-			tmp3->parent = tmp;
-
-		    tmp->section = tmp2->section;
-		    tmp->general = tmp2->general;
-		    tmp->protection = tmp2->protection;
-		    tmp->ownPage = tmp2->ownPage;
-		    tmp->sub = tmp2->sub;
-		    tmp->type = tmp2->type;
-		    tmp->name = newName;
-		    tmp->args = tmp2->args;
-		    tmp->memo = tmp2->memo;
-		    tmp->doc = tmp2->doc;
-		    tmp->program = tmp2->program;
-		    tmp->author = tmp2->author;
-		    tmp->version = tmp2->version;
-		    tmp->see = tmp2->see;
-		    tmp->param = tmp2->param;
-		    tmp->exception = tmp2->exception;
-		    tmp->precondition = tmp2->precondition;
-        	    tmp->postcondition = tmp2->postcondition;
-        	    tmp->invariant = tmp2->invariant;
-		    tmp->retrn = tmp2->retrn;
-		    tmp->sublist = tmp2->sublist;
-		    tmp->pubChilds = tmp2->pubChilds;
-		    tmp->proChilds = tmp2->proChilds;
-		    tmp->priChilds = tmp2->priChilds;
-		    tmp->baseclasses = tmp2->baseclasses;
-		    tmp->pubBaseclasses = tmp2->pubBaseclasses;
-		    tmp->proBaseclasses = tmp2->proBaseclasses;
-		    tmp->priBaseclasses = tmp2->priBaseclasses;
-		    tmp->otherPubBaseclasses = tmp2->otherPubBaseclasses;
-		    tmp->otherProBaseclasses = tmp2->otherProBaseclasses;
-		    tmp->otherPriBaseclasses = tmp2->otherPriBaseclasses;
-		    tmp->implements = tmp2->implements;
-		    tmp->extends = tmp2->extends;
-		    tmp->import = tmp2->import;
-		    tmp->override = tmp2->override;
+		    const EntryExtra& from = tmp2->constExtra();
+		    EntryExtra& to = tmp->extra();
+
+		    to.author = from.author;
+		    to.version = from.version;
+		    to.see = from.see;
+		    to.param = from.param;
+		    to.exception = from.exception;
+		    to.precondition = from.precondition;
+		    to.postcondition = from.postcondition;
+		    to.invariant = from.invariant;
+		    to.retrn = from.retrn;
+		    to.pubChilds = from.pubChilds;
+		    to.proChilds = from.proChilds;
+		    to.priChilds = from.priChilds;
+		    to.baseclasses = from.baseclasses;
+		    to.pubBaseclasses = from.pubBaseclasses;
+		    to.proBaseclasses = from.proBaseclasses;
+		    to.priBaseclasses = from.priBaseclasses;
+		    to.otherPubBaseclasses = from.otherPubBaseclasses;
+		    to.otherProBaseclasses = from.otherProBaseclasses;
+		    to.otherPriBaseclasses = from.otherPriBaseclasses;
+		    to.implements = from.implements;
+		    to.extends = from.extends;
+		    to.import = from.import;
 		    }
-	    	}
-	}
+		tmp->override = tmp2->override;
+		}
+	    }
 }
 
 void reNumber(Entry *tp)
 {
-    Entry *tmp = tp;
-    int	i = 1;
+    Entry *tmp;
+    int	i, n = 1;
 
-    for(tmp = tp->sub; tmp; tmp = tmp->next)
+    for(i = 0; i < tp->subEntries.size(); i++)
 	{
+	tmp = tp->subEntries[i];
 	if(MAKE_DOC(tmp))
-	    tmp->subnumber = i++;
+	    tmp->subnumber = n++;
 	reNumber(tmp);
 	}
-    for(tmp = tp->sub; tmp; tmp = tmp->next)
-	if(!MAKE_DOC(tmp))
-	    tmp->subnumber = i++;
+    for(i = 0; i < tp->subEntries.size(); i++)
+	if(!MAKE_DOC(tp->subEntries[i]))
+	    tp->subEntries[i]->subnumber = n++;
 }
 
 bool relevantClassGraphs(Entry *tmp)
 {
-    for(; tmp; tmp = tmp->next)
-	{
-	if((tmp->section & CLASS_SEC) &&
-	    tmp->proBaseclasses.size() == 0 &&
-	    tmp->pubBaseclasses.size() == 0)
-	    return true;
-	if(relevantClassGraphs(tmp->sub))
+    int i;
+
+    if((tmp->section & CLASS_SEC) &&
+	tmp->constExtra().proBaseclasses.size() == 0 &&
+	tmp->constExtra().pubBaseclasses.size() == 0)
+	return true;
+    for(i = 0; i < tmp->subEntries.size(); i++)
+	if(relevantClassGraphs(tmp->subEntries[i]))
 	    return true;
-	}
 
     return false;
 }
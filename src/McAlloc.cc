@@ -0,0 +1,48 @@
+/*
+  McAlloc.cc
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this program; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "McAlloc.h"
+
+static McAllocator libcAllocator = { malloc, realloc, free };
+
+McAllocator *mcAllocator = &libcAllocator;
+bool mcAllocAccounting = false;
+unsigned char mcAllocScope = MC_TAG_OTHER;
+McAllocCount mcAllocCounts[MC_NUM_TAGS];
+
+const char *mcAllocTagName(int tag)
+{
+    static const char *names[MC_NUM_TAGS] =
+	{ "other", "entries", "scanner", "html", "hash tables", "name tables" };
+
+    return (tag >= 0 && tag < MC_NUM_TAGS) ? names[tag] : "?";
+}
+
+char *mcStrdup(const char *str, int tag)
+{
+    size_t n = strlen(str) + 1;
+    char *copy = (char *)mcMalloc(n, tag);
+
+    memcpy(copy, str, n);
+    return copy;
+}
@@ -0,0 +1,151 @@
+/*
+  McAlloc.h
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this program; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef _MC_ALLOC_H
+#define _MC_ALLOC_H
+
+#include <stddef.h>
+
+/** @name Heap allocation of the Mc* containers
+
+    #McDArray#, #McString#, #McHashTable# and the names of #NameTable# get
+    their memory through #mcMalloc()#, #mcRealloc()# and #mcFree()#. These
+    call the functions of #mcAllocator#, which can be replaced, and account
+    for every block under a tag naming the subsystem it belongs to. The
+    callers pass the size of the block when freeing it, so no header has to
+    be kept with each block.
+
+    An array takes its tag from #mcAllocScope# when it is constructed, a copy
+    that of the original, unless it is changed with #McDArray::setTag()#. Hash tables always use
+    #MC_TAG_HASH#.
+*/
+//@{
+/// Subsystems memory is accounted to
+enum McAllocTag
+{
+    MC_TAG_OTHER = 0,
+    MC_TAG_ENTRY,		// fields of Entry objects
+    MC_TAG_SCANNER,		// input buffers and source copies
+    MC_TAG_HTML,		// HTML strings and the HTML writer
+    MC_TAG_HASH,		// McHashTable buckets and items
+    MC_TAG_NAMES,		// NameTable names and index
+    MC_NUM_TAGS
+};
+
+/// Functions used to get memory, all three must fit together
+struct McAllocator
+{
+    void *(*alloc)(size_t size);
+    void *(*realloc)(void *ptr, size_t size);
+    void (*free)(void *ptr);
+};
+
+/// Counters of one tag
+struct McAllocCount
+{
+    long live;			// bytes currently allocated
+    long peak;			// maximum of #live#
+    long count;			// number of allocations, reallocations included
+};
+
+/// the allocator in use, #malloc()#, #realloc()# and #free()# by default
+extern McAllocator *mcAllocator;
+
+/// true if allocations are to be counted (#--mem-report#)
+extern bool mcAllocAccounting;
+
+/// tag given to arrays constructed now
+extern unsigned char mcAllocScope;
+
+/// counters per tag
+extern McAllocCount mcAllocCounts[MC_NUM_TAGS];
+
+/// name of #tag# for reports
+extern const char *mcAllocTagName(int tag);
+
+/// account #delta# bytes to #tag#, a positive #delta# counts as allocation
+inline void mcAllocAccount(int tag, long delta)
+{
+    if(mcAllocAccounting)
+	{
+	McAllocCount& c = mcAllocCounts[tag];
+	c.live += delta;
+	if(delta > 0)
+	    c.count++;
+	if(c.live > c.peak)
+	    c.peak = c.live;
+	}
+}
+
+/// move #size# live bytes from tag #from# to tag #to#
+inline void mcAllocMove(int from, int to, long size)
+{
+    if(mcAllocAccounting)
+	{
+	mcAllocCounts[from].live -= size;
+	mcAllocCounts[to].live += size;
+	if(mcAllocCounts[to].live > mcAllocCounts[to].peak)
+	    mcAllocCounts[to].peak = mcAllocCounts[to].live;
+	}
+}
+
+inline void *mcMalloc(size_t size, int tag)
+{
+    mcAllocAccount(tag, (long)size);
+    return mcAllocator->alloc(size);
+}
+
+inline void *mcRealloc(void *ptr, size_t oldSize, size_t size, int tag)
+{
+    mcAllocAccount(tag, (long)size - (long)oldSize);
+    if(mcAllocAccounting && size <= oldSize)
+	mcAllocCounts[tag].count++;
+    return mcAllocator->realloc(ptr, size);
+}
+
+inline void mcFree(void *ptr, size_t size, int tag)
+{
+    mcAllocAccount(tag, -(long)size);
+    mcAllocator->free(ptr);
+}
+
+/// copy of #str# allocated with #mcMalloc()#
+extern char *mcStrdup(const char *str, int tag);
+
+/// Sets #mcAllocScope# for the lifetime of the object
+class McAllocScope
+{
+public:
+    McAllocScope(int tag) : saved(mcAllocScope)
+	{
+	mcAllocScope = (unsigned char)tag;
+	}
+
+    ~McAllocScope()
+	{
+	mcAllocScope = saved;
+	}
+
+private:
+    unsigned char saved;
+};
+//@}
+
+#endif
@@ -30,6 +30,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "McAlloc.h"
+
 extern bool fastNotSmall;
 
 /** Dynamic array for primitive data objects.
@@ -62,7 +64,9 @@ extern bool fastNotSmall;
 
     NOTE: malloc is used to allocate McDArray data. This is done to avoid the
     need to call default and copy constructors when creating and moving arrays.
-    We assume outside code will handle initialization.
+    We assume outside code will handle initialization. The memory is taken
+    through #mcMalloc()# and accounted to the tag of the array, see
+    \Ref{Heap allocation of the Mc* containers}.
 */
 
 template<class T> class McDArray
@@ -78,9 +82,9 @@ public:
 
     /// Copy constructor.
     McDArray(const McDArray& old) : memFactor(old.memFactor),
-	thesize(old.thesize), themax(old.themax)
+	thesize(old.thesize), themax(old.themax), tag(old.tag)
 	{
-	data = (T*)malloc(themax * sizeof(T));
+	data = (T*)mcMalloc(themax * sizeof(T), tag);
 	if(thesize)
 	    memcpy(data, old.data, thesize * sizeof(T));
 	assert(isConsistent());
@@ -92,12 +96,13 @@ public:
 	uninitialized elements. The internal array is allocated to have
 	#max# nonzeros, and the memory extension factor is set to #fac#.
     */
-    McDArray(int size = 0, int max = 0, float fac = 1.2) : memFactor(fac)
+    McDArray(int size = 0, int max = 0, float fac = 1.2) : memFactor(fac),
+	tag(mcAllocScope)
 	{
 	thesize = (size < 0) ? 0 : size;
 	themax = (max > thesize) ? max : thesize;
 	if(themax)
-	    data = (T *)malloc(themax * sizeof(T));
+	    data = (T *)mcMalloc(themax * sizeof(T), tag);
 	else
 	    data = 0;
 	assert(isConsistent());
@@ -107,7 +112,14 @@ public:
     ~McDArray()
 	{
 	if(data)
-	    free(data);
+	    mcFree(data, themax * sizeof(T), tag);
+	}
+
+    /// Account the memory of the array to #newTag# from now on.
+    void setTag(int newTag)
+	{
+	mcAllocMove(tag, newTag, themax * sizeof(T));
+	tag = (unsigned char)newTag;
 	}
 
     /// Append element #t# to #McDArray#.
@@ -325,13 +337,14 @@ public:
 
 	if(themax)
 	    if(data)
-		data = (T*)realloc(data, themax * sizeof(T));
+		data = (T*)mcRealloc(data, oldmax * sizeof(T),
+		    themax * sizeof(T), tag);
 	    else
-		data = (T*)malloc(themax * sizeof(T));
+		data = (T*)mcMalloc(themax * sizeof(T), tag);
 	else
 	    {
 	    if(data)
-		free(data);
+		mcFree(data, oldmax * sizeof(T), tag);
 	    data = 0;
 	    }
 	return oldmax - themax;
@@ -364,6 +377,7 @@ public:
   protected:
     int thesize;	// Number of active elements in array
     int themax;		// Determines size of internal buffer
+    unsigned char tag;	// McAllocTag the memory is accounted to
     T *data;		// Pointer t internal buffer
 };
 
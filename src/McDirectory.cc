@@ -25,6 +25,7 @@
 #include "McDirectory.h"
 #include "McSorter.h"
 #include "McString.h"
+#include "McWildMatch.h"
 #include "doc.h"
 
 #include <stdio.h>
@@ -66,6 +67,35 @@ int McDirectory::scan(const McString& dirname, McDArray<char *> &list,
     return 0;
 }
 
+int McDirectory::entries(const McString& dirname, McDArray<char *> &dirs,
+			 McDArray<char *> &files)
+{
+    WIN32_FIND_DATA findFileData;
+    char buf[1024];
+
+    sprintf(buf, "%s\\*", dirname.c_str());
+
+    HANDLE searchHandle = FindFirstFile(buf, &findFileData);
+    if(searchHandle == INVALID_HANDLE_VALUE)
+	{
+	fprintf(stderr, _("Can't open `%s' dir\n"), dirname.c_str());
+	return 0;
+	}
+    do
+	{
+	if(findFileData.cFileName[0] != '.')
+	    {
+	    if(findFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		dirs.append(_strdup(findFileData.cFileName));
+	    else
+		files.append(_strdup(findFileData.cFileName));
+	    }
+	}
+    while(FindNextFile(searchHandle, &findFileData));
+    FindClose(searchHandle);
+    return dirs.size() + files.size();
+}
+
 int McDirectory::isDirectory(const McString& dirname)
 {
     McString d(dirname);
@@ -111,6 +141,44 @@ int McDirectory::scan(const McString& dirname, McDArray<char *> &list,
     return list.size();
 }
 
+int McDirectory::entries(const McString& dirname, McDArray<char *> &dirs,
+			 McDArray<char *> &files)
+{
+    DIR *dir = opendir(dirname.c_str());
+    struct dirent *entry;
+
+    if(!dir)
+	{
+	fprintf(stderr, _("Can't open `%s' dir\n"), dirname.c_str());
+	return 0;
+	}
+
+    while((entry = readdir(dir)))
+	if(entry->d_name[0] != '.')
+	    {
+	    bool isDir;
+
+#ifdef DT_DIR
+	    // most file systems give the type, which saves looking at the entry
+	    if(entry->d_type == DT_DIR || entry->d_type == DT_REG)
+		isDir = (entry->d_type == DT_DIR);
+	    else
+#endif
+		{
+		McString path = dirname;
+		path += pathDelimiter();
+		path += entry->d_name;
+		isDir = isDirectory(path);
+		}
+	    if(isDir)
+		dirs.append(strdup(entry->d_name));
+	    else
+		files.append(strdup(entry->d_name));
+	    }
+    closedir(dir);
+    return dirs.size() + files.size();
+}
+
 int McDirectory::isDirectory(const McString& dirname)
 {
     McString d(dirname);
@@ -126,3 +194,59 @@ int McDirectory::isDirectory(const McString& dirname)
     return 1;
 }
 #endif
+
+void McDirectory::walk(const McString& dirname, McDArray<char *> &list,
+		       const char *pattern, const McGlobSet& include,
+		       const McGlobSet& exclude)
+{
+    walk(dirname, "", list, pattern, include, exclude);
+}
+
+void McDirectory::walk(const McString& dirname, const McString& relative,
+		       McDArray<char *> &list, const char *pattern,
+		       const McGlobSet& include, const McGlobSet& exclude)
+{
+    McDArray<char *> dirs, files;
+    StringCompare comp;
+    int i;
+
+    entries(dirname, dirs, files);
+    if(dirs.size())
+	sort((char **)dirs, dirs.size(), comp, 0);
+    if(files.size())
+	sort((char **)files, files.size(), comp, 0);
+
+    // the patterns always see `/' between the parts of a path
+    for(i = 0; i < dirs.size(); i++)
+	{
+	McString rel = relative;
+	if(rel.length())
+	    rel += '/';
+	rel += dirs[i];
+	if(!exclude.matches(rel.c_str()))
+	    {
+	    McString path = dirname;
+	    path += pathDelimiter();
+	    path += dirs[i];
+	    walk(path, rel, list, pattern, include, exclude);
+	    }
+	free(dirs[i]);
+	}
+
+    for(i = 0; i < files.size(); i++)
+	{
+	McString rel = relative;
+	if(rel.length())
+	    rel += '/';
+	rel += files[i];
+	if((include.size() ? include.matches(rel.c_str()) :
+	    mcWildMatch(files[i], pattern)) && !exclude.matches(rel.c_str()))
+	    {
+	    McString path = dirname;
+	    path += pathDelimiter();
+	    path += files[i];
+	    list.append(strdup(path.c_str()));
+	    }
+	free(files[i]);
+	}
+}
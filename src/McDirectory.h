@@ -25,6 +25,7 @@
 #define _MCDIRECTORY_H
 
 #include "McDArray.h"
+#include "McGlobSet.h"
 #include "McString.h"
 
 #if defined(WIN32) || defined(__BORLANDC__) || defined(__VISUALC__) || defined(__WATCOMC__) || defined(__MINGW32__)
@@ -55,7 +56,27 @@ public:
   /// Check whether a given name is directory.
   static int isDirectory(const McString& dirname);
 
+  /** Lists the files in a directory tree.
+
+    Walks the tree below #dirname# once and appends the paths of its files
+    to #list#. A file is taken if its path relative to #dirname# matches
+    #include#, or its name matches #pattern# if #include# is empty. Files
+    and directories matching #exclude# are left out, an excluded directory
+    is not entered. The files of the subdirectories come before those of a
+    directory, each sorted by name.
+  */
+  static void walk(const McString& dirname, McDArray<char *> &list,
+    const char *pattern, const McGlobSet& include, const McGlobSet& exclude);
+
 protected:
+    // lists the entries of #dirname#, sorted into directories and files
+    static int entries(const McString& dirname, McDArray<char *> &dirs,
+	McDArray<char *> &files);
+
+    static void walk(const McString& dirname, const McString& relative,
+	McDArray<char *> &list, const char *pattern, const McGlobSet& include,
+	const McGlobSet& exclude);
+
     class StringCompare
 	{
 	public:
@@ -0,0 +1,198 @@
+/*
+  McGlobSet.cc
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this program; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <string.h>
+
+#include "McGlobSet.h"
+
+McGlobSet::McGlobSet() : patterns(0), generation(0)
+{
+}
+
+void McGlobSet::add(const char *pattern)
+{
+    Step step;
+    int i;
+
+    if(strchr(pattern, '/'))
+	pathStarts.append(steps.size());
+    else
+	nameStarts.append(steps.size());
+    patterns++;
+
+    for(const char *p = pattern; *p; p++)
+	{
+	step.c = 0;
+	step.cls = 0;
+	switch(*p)
+	    {
+	    case '*':
+		step.type = STAR;
+		if(p[1] == '*')
+		    {
+		    step.type = STARS;
+		    while(p[1] == '*')
+			p++;
+		    // `**/' may match no directory at all
+		    if(p[1] == '/')
+			{
+			step.type = DIRS;
+			steps.append(step);
+			step.type = STARS;
+			}
+		    }
+		break;
+	    case '?':
+		step.type = ANY;
+		break;
+	    case '[':
+		{
+		const char *q = p + 1;
+		bool negate = (*q == '!');
+
+		if(negate)
+		    q++;
+		// a `]' right at the start belongs to the class
+		const char *end = strchr(*q == ']' ? q + 1 : q, ']');
+		if(!end)
+		    {
+		    // no class, but the character itself
+		    step.type = CHAR;
+		    step.c = '[';
+		    break;
+		    }
+		step.type = CLASS;
+		step.cls = classes.size();
+		for(i = 0; i < 256; i++)
+		    classes.append(negate);
+		for(; q < end; q++)
+		    if(q[1] == '-' && q + 2 < end)
+			{
+			for(i = (unsigned char)q[0]; i <= (unsigned char)q[2]; i++)
+			    classes[step.cls + i] = !negate;
+			q += 2;
+			}
+		    else
+			classes[step.cls + (unsigned char)*q] = !negate;
+		classes[step.cls + '/'] = false;
+		p = end;
+		break;
+		}
+	    default:
+		step.type = CHAR;
+		step.c = *p;
+		break;
+	    }
+	steps.append(step);
+	}
+    step.type = MATCH;
+    steps.append(step);
+
+    while(seen.size() < steps.size())
+	seen.append(0);
+}
+
+/* Adds #step# to #states#, unless it is there already. A star may match
+   nothing, so the step after it is entered too. #DIRS# may match no
+   directory, so the step after its ``/'' is entered too.
+*/
+void McGlobSet::enter(McDArray<int>& states, int step) const
+{
+    while(seen[step] != generation)
+	{
+	seen[step] = generation;
+	states.append(step);
+	if(steps[step].type == DIRS)
+	    enter(states, step + 3);
+	else
+	    if(steps[step].type != STAR && steps[step].type != STARS)
+		break;
+	step++;
+	}
+}
+
+bool McGlobSet::matches(const char *path) const
+{
+    McDArray<int> *now = &states[0];
+    McDArray<int> *next = &states[1];
+    McDArray<int> *t;
+    int i;
+
+    if(patterns == 0)
+	return false;
+
+    now->resize(0);
+    generation++;
+    for(i = 0; i < pathStarts.size(); i++)
+	enter(*now, pathStarts[i]);
+    for(i = 0; i < nameStarts.size(); i++)
+	enter(*now, nameStarts[i]);
+
+    for(const char *p = path; *p; p++)
+	{
+	unsigned char c = *p;
+
+	next->resize(0);
+	generation++;
+	for(i = 0; i < now->size(); i++)
+	    {
+	    int s = (*now)[i];
+	    const Step& step = steps[s];
+
+	    switch(step.type)
+		{
+		case CHAR:
+		    if(step.c == c)
+			enter(*next, s + 1);
+		    break;
+		case ANY:
+		    if(c != '/')
+			enter(*next, s + 1);
+		    break;
+		case CLASS:
+		    if(classes[step.cls + c])
+			enter(*next, s + 1);
+		    break;
+		case STAR:
+		    if(c != '/')
+			enter(*next, s);
+		    break;
+		case STARS:
+		    enter(*next, s);
+		    break;
+		}
+	    }
+	// patterns without a `/' start again with every part of the path
+	if(c == '/')
+	    for(i = 0; i < nameStarts.size(); i++)
+		enter(*next, nameStarts[i]);
+
+	t = now;
+	now = next;
+	next = t;
+	if(now->size() == 0 && nameStarts.size() == 0)
+	    return false;
+	}
+
+    for(i = 0; i < now->size(); i++)
+	if(steps[(*now)[i]].type == MATCH)
+	    return true;
+    return false;
+}
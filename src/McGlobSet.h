@@ -0,0 +1,83 @@
+/*
+  McGlobSet.h
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this program; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef _MC_GLOB_SET_H
+#define _MC_GLOB_SET_H
+
+#include "McDArray.h"
+
+/** A set of glob patterns, as given with #--include# and #--exclude#.
+
+    ``*'' matches any characters but ``/'', ``**'' any characters at all
+    and, followed by ``/'', any number of directories, none too, ``?'' one
+    character but ``/'' and ``[...]'' one character of a class, which is
+    negated by a leading ``!''. Paths are relative and have ``/''
+    between their parts. A pattern with a ``/'' must match the whole path,
+    one without only its last part.
+
+    All patterns are compiled into one nondeterministic automaton, which
+    is run once over a path, whatever the number of patterns. Its cost
+    does not depend on how the stars of the patterns could be matched.
+*/
+class McGlobSet
+{
+public:
+    McGlobSet();
+
+    /// add #pattern# to the set
+    void add(const char *pattern);
+
+    /// number of patterns in the set
+    int size() const
+	{
+	return patterns;
+	}
+
+    /// true if a pattern of the set matches #path#
+    bool matches(const char *path) const;
+
+private:
+    enum { CHAR, ANY, CLASS, STAR, STARS, DIRS, MATCH };
+
+    /* a step of the automaton, number #i# leads to number #i + 1#, #DIRS#
+       also to #i + 3#, past the #STARS# and the ``/'' after it
+    */
+    struct Step
+    {
+	unsigned char type;
+	unsigned char c;	// for #CHAR#
+	int cls;		// for #CLASS#, the first of 256 in #classes#
+    };
+
+    McDArray<Step> steps;
+    McDArray<bool> classes;
+    McDArray<int> pathStarts;	// first steps of the patterns with a `/'
+    McDArray<int> nameStarts;	// and of those without
+    int patterns;
+
+    // for #matches()#, the steps active before and after a character
+    mutable McDArray<int> states[2];
+    mutable McDArray<int> seen;
+    mutable int generation;
+
+    void enter(McDArray<int>& states, int step) const;
+};
+
+#endif
@@ -30,6 +30,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "McAlloc.h"
+
 /** @name Predefined hash and compare methods. */
 //@{
 
@@ -66,9 +68,9 @@ extern int compare(int i1, int i2);
     use appropriate pointers as key or value types. Preferable these
     should be smart pointers as provided by \Ref{McHandle}.
 
-    NOTE: `calloc' is used so that initial buckets are all 0. It isn't
-    clear this has an advantage over `new' other than zeroing things
-    automatically.
+    NOTE: The bucket array and the items are taken from #mcMalloc()# and
+    accounted to #MC_TAG_HASH#, see \Ref{Heap allocation of the Mc*
+    containers}.
 */
 
 template<class Key, class Value> class McHashTable
@@ -86,6 +88,12 @@ public:
 	return nItems;
 	}
 
+    /// Number of buckets.
+    int buckets() const
+	{
+	return mask + 1;
+	}
+
     /** Read-write access via index operator.
 
 	If the given key does not already exist, a new table entry is
@@ -149,6 +157,14 @@ protected:
 	Item(const Key& k, const Value& v) : key(k), value(v), next(0)
 	    {
 	    }
+	void *operator new(size_t size)
+	    {
+	    return mcMalloc(size, MC_TAG_HASH);
+	    }
+	void operator delete(void *ptr, size_t size)
+	    {
+	    mcFree(ptr, size, MC_TAG_HASH);
+	    }
 	};
 
     void rebuildTable();   // Adjusts size of bucket array.
@@ -185,7 +201,7 @@ McHashTable<Key,Value>::~McHashTable()
 	    }
 	}
     if(bucketList != staticList)
-	free(bucketList);
+	mcFree(bucketList, (mask + 1) * sizeof(Item *), MC_TAG_HASH);
 }
 
 template<class Key, class Value>
@@ -276,7 +292,8 @@ void McHashTable<Key,Value>::rebuildTable()
     Item **oldList = bucketList;
     int size = mask + 1;
     mask = (mask << 1) + 1;
-    bucketList = (Item **)calloc(2 * size, sizeof(Item));
+    bucketList = (Item **)mcMalloc(2 * size * sizeof(Item *), MC_TAG_HASH);
+    memset(bucketList, 0, 2 * size * sizeof(Item *));
 
     for(int i = 0; i < size; i++)
 	{
@@ -293,7 +310,7 @@ void McHashTable<Key,Value>::rebuildTable()
 	}
 
     if(oldList != staticList)
-	free(oldList);
+	mcFree(oldList, size * sizeof(Item *), MC_TAG_HASH);
 }
 
 template<class Key, class Value>
@@ -0,0 +1,123 @@
+/*
+  McMappedFile.cc
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this program; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "McMappedFile.h"
+
+#if defined(WIN32) || defined(__BORLANDC__) || defined(__VISUALC__) || defined(__WATCOMC__) || defined(__MINGW32__)
+
+bool McMappedFile::open(const char *path)
+{
+    close();
+
+    FILE *in = fopen(path, "rb");
+    if(!in)
+	return false;
+
+    fseek(in, 0, SEEK_END);
+    long n = ftell(in);
+    fseek(in, 0, SEEK_SET);
+
+    char *buf = (char *)malloc(n > 0 ? n : 1);
+    if(n < 0 || (long)fread(buf, 1, n, in) != n)
+	{
+	free(buf);
+	fclose(in);
+	return false;
+	}
+    fclose(in);
+
+    base = buf;
+    length = n;
+    mapped = false;
+    return true;
+}
+
+void McMappedFile::close()
+{
+    if(base)
+	free((char *)base);
+    base = 0;
+    length = 0;
+}
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool McMappedFile::open(const char *path)
+{
+    struct stat st;
+
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if(fd < 0)
+	return false;
+
+    if(fstat(fd, &st) != 0)
+	{
+	::close(fd);
+	return false;
+	}
+
+    length = st.st_size;
+    if(length == 0)
+	{
+	// mmap() refuses empty files
+	base = (const char *)malloc(1);
+	mapped = false;
+	}
+    else
+	{
+	void *p = mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(p == MAP_FAILED)
+	    {
+	    ::close(fd);
+	    length = 0;
+	    return false;
+	    }
+	base = (const char *)p;
+	mapped = true;
+	}
+    ::close(fd);
+    return true;
+}
+
+void McMappedFile::close()
+{
+    if(base)
+	{
+	if(mapped)
+	    munmap((void *)base, length);
+	else
+	    free((char *)base);
+	}
+    base = 0;
+    length = 0;
+    mapped = false;
+}
+
+#endif
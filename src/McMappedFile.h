@@ -0,0 +1,76 @@
+/*
+  McMappedFile.h
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this program; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef _MC_MAPPED_FILE_H
+#define _MC_MAPPED_FILE_H
+
+/** Read-only view of a whole file.
+
+    The file is mapped into memory where the system supports it and read into
+    a heap buffer otherwise, so #data()# can be used the same way in both
+    cases. The view stays valid until #close()# is called or the object is
+    destroyed.
+*/
+class McMappedFile
+{
+public:
+    /// open #path#, returns #false# if it can't be read
+    bool open(const char *path);
+
+    /// release the view
+    void close();
+
+    ///	is a file open?
+    bool isOpen() const
+	{
+	return base != 0;
+	}
+
+    ///	contents of the file
+    const char *data() const
+	{
+	return base;
+	}
+
+    ///	size of the file in bytes
+    unsigned long size() const
+	{
+	return length;
+	}
+
+    McMappedFile() : base(0), length(0), mapped(false)
+	{
+	}
+
+    ~McMappedFile()
+	{
+	close();
+	}
+
+private:
+    const char *base;
+    unsigned long length;
+    bool mapped;
+
+    McMappedFile(const McMappedFile&);
+    McMappedFile& operator = (const McMappedFile&);
+};
+
+#endif
@@ -0,0 +1,104 @@
+/*
+  McScan.cc
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this program; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "McScan.h"
+
+McScanSet::McScanSet(const char *chars)
+{
+    int n = strlen(chars);
+
+    assert(n <= MAX);
+    memset(member, 0, sizeof(member));
+    member[0] = true;
+    for(int i = 0; i < n; i++)
+	member[(unsigned char)chars[i]] = true;
+    memcpy(list, chars, n + 1);
+}
+
+#if defined(__SSE2__)
+
+static inline int lowestBit(unsigned int mask)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(mask);
+#else
+    int i = 0;
+
+    while(!(mask & 1))
+	{
+	mask >>= 1;
+	i++;
+	}
+    return i;
+#endif
+}
+
+const char *mcScan(const char *str, const McScanSet& set)
+{
+    // up to the first 16 byte boundary one by one
+    while(((unsigned long)str & 15) != 0)
+	{
+	if(set.has(*str))
+	    return str;
+	str++;
+	}
+
+    const char *chars = set.chars();
+    int n = strlen(chars);
+    __m128i wanted[McScanSet::MAX];
+    const __m128i zero = _mm_setzero_si128();
+    int i;
+
+    for(i = 0; i < n; i++)
+	wanted[i] = _mm_set1_epi8(chars[i]);
+
+    // An aligned block never crosses a page boundary, so the bytes read
+    // behind the terminating 0 are always accessible.
+    for(;; str += 16)
+	{
+	__m128i block = _mm_load_si128((const __m128i *)str);
+	__m128i hit = _mm_cmpeq_epi8(block, zero);
+
+	for(i = 0; i < n; i++)
+	    hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, wanted[i]));
+
+	unsigned int mask = _mm_movemask_epi8(hit);
+	if(mask)
+	    return str + lowestBit(mask);
+	}
+}
+
+#else
+
+const char *mcScan(const char *str, const McScanSet& set)
+{
+    while(!set.has(*str))
+	str++;
+    return str;
+}
+
+#endif
@@ -0,0 +1,61 @@
+/*
+  McScan.h
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this program; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef _MC_SCAN_H
+#define _MC_SCAN_H
+
+/** A set of at most #MAX# characters to look for with #mcScan()#.
+
+    The scanners of the output formats copy most characters as they are and
+    only act upon a few. Such a set holds the characters a scanner acts
+    upon, so that the text in between can be copied at once.
+*/
+class McScanSet
+{
+public:
+    enum { MAX = 16 };
+
+    /// the set of the characters in #chars#
+    McScanSet(const char *chars);
+
+    /// true if #c# is in the set, the terminating 0 always is
+    bool has(char c) const
+	{
+	return member[(unsigned char)c];
+	}
+
+    /// characters of the set, the terminating 0 not included
+    const char *chars() const
+	{
+	return list;
+	}
+
+private:
+    bool member[256];
+    char list[MAX + 1];
+};
+
+/** Returns a pointer to the first character of #str# that is in #set#, or to
+    the terminating 0. Where SSE2 is available, 16 characters are looked at
+    at once.
+*/
+const char *mcScan(const char *str, const McScanSet& set);
+
+#endif
@@ -26,265 +26,254 @@
 
 #include "classgraph.h"
 
-void ClassGraph::addAllChilds()
+/** The pieces of the class graphs a class takes part in. #bases# are the
+    lines above the class, indented relative to it, #childs# the lines of all
+    derived classes without the arrows leading to the class itself.
+*/
+struct ClassGraphCache
+{
+    ClassGraphCache() : haveBases(false), haveChilds(false)
+	{
+	layout[0] = layout[1] = 0;
+	}
+
+    ~ClassGraphCache()
+	{
+	int i;
+
+	for(i = 0; i < bases.size(); ++i)
+	    delete bases[i];
+	for(i = 0; i < childs.size(); ++i)
+	    delete childs[i];
+	delete layout[0];
+	delete layout[1];
+	}
+
+    bool haveBases;
+    bool haveChilds;
+    McDArray<ClassGraph*> bases;
+    McDArray<ClassGraph*> childs;
+    ClassGraphLayout *layout[2];
+};
+
+void freeClassGraphCache(ClassGraphCache *c)
 {
-    addChilds("", 1);
+    delete c;
 }
 
-void ClassGraph::addBases()
+static ClassGraphCache& cacheOf(Entry *cls)
 {
-    int	i;
-    int	first = 1;
-    ClassGraph *base = 0;
+    EntryExtra& x = cls->extra();
 
-    assert(entry);
+    if(!x.graph)
+	x.graph = new ClassGraphCache;
+    return *x.graph;
+}
 
-    for(i = 0; i < entry->pubBaseclasses.size(); ++i)
-	{
-	base = new ClassGraph(entry->pubBaseclasses[i], indent - 1);
-	base->nextLine = firstLine;
-	if		// determine, wether this is the first one in child graph
-	    (i == entry->pubBaseclasses.size() - 1	&&
-	    entry->otherPubBaseclasses.size() == 0	&&
-	    entry->proBaseclasses.size() == 0		&&
-	    entry->otherProBaseclasses.size() == 0	&&
-	    (withPrivate == 0 ||
-		(entry->priBaseclasses.size() == 0	&&
-		entry->otherPriBaseclasses.size() == 0)))
-	    base->after += first ? "d" : "l";
-	else
-	    base->after += first ? "D" : "L";
-	base->after += "_";
-	base->addBases();
-	firstLine = base->firstLine;
-	first = 0;
-	}
+static void addBase(McDArray<ClassGraph*>& direct, ClassGraph *base,
+    const char *prot)
+{
+    base->after = prot;
+    direct.append(base);
+}
 
-    for(i = 0; i < entry->otherPubBaseclasses.size(); ++i)
-	{
-	base = new ClassGraph(*(entry->otherPubBaseclasses[i]), indent - 1);
-	base->nextLine = firstLine;
-	if		// determine, wether this is the first one in child graph
-	    (i == entry->otherPubBaseclasses.size() - 1	&&
-	    entry->proBaseclasses.size() == 0		&&
-	    entry->otherProBaseclasses.size() == 0	&&
-	    (withPrivate == 0 ||
-		(entry->priBaseclasses.size() == 0	&&
-		entry->otherPriBaseclasses.size() == 0)))
-	    base->after += first ? "d" : "l";
-	else
-	    base->after += first ? "D" : "L";
-	base->after += "_";
-	firstLine = base->firstLine;
-	first = 0;
-	}
+/* The lines above #cls#. Every base class gets a line one column to the
+   left, preceded by the lines of its own bases; the base listed last ends
+   up at the top.
+*/
+static const McDArray<ClassGraph*>& basesOf(Entry *cls)
+{
+    ClassGraphCache& c = cacheOf(cls);
 
-    for(i = 0; i < entry->proBaseclasses.size(); ++i)
-	{
-	base = new ClassGraph(entry->proBaseclasses[i], indent - 1);
-	base->nextLine = firstLine;
-	if		// determine, wether this is the first one in child graph
-	    (i == entry->proBaseclasses.size() - 1	&&
-	    entry->otherProBaseclasses.size() == 0	&&
-	    (withPrivate == 0 ||
-		(entry->priBaseclasses.size() == 0	&&
-		entry->otherPriBaseclasses.size() == 0)))
-	    base->after += first ? "d" : "l";
-	else
-	    base->after += first ? "D" : "L";
-	base->after += "-";
-	base->addBases();
-	firstLine = base->firstLine;
-	first = 0;
-	}
+    if(c.haveBases)
+	return c.bases;
+    c.haveBases = true;
+
+    const EntryExtra& x = cls->constExtra();
+    McDArray<ClassGraph*> direct;
+    int i, j;
 
-    for(i = 0; i < entry->otherProBaseclasses.size(); ++i)
+    for(i = 0; i < x.pubBaseclasses.size(); ++i)
+	addBase(direct, new ClassGraph(x.pubBaseclasses[i], -1), "_");
+    for(i = 0; i < x.otherPubBaseclasses.size(); ++i)
+	addBase(direct, new ClassGraph(*(x.otherPubBaseclasses[i]), -1), "_");
+    for(i = 0; i < x.proBaseclasses.size(); ++i)
+	addBase(direct, new ClassGraph(x.proBaseclasses[i], -1), "-");
+    for(i = 0; i < x.otherProBaseclasses.size(); ++i)
+	addBase(direct, new ClassGraph(*(x.otherProBaseclasses[i]), -1), "-");
+    if(withPrivate)
 	{
-	base = new ClassGraph(*(entry->otherProBaseclasses[i]), indent - 1);
-	base->nextLine = firstLine;
-	if		// determine, wether this is the first one in child graph
-	    (i == entry->otherProBaseclasses.size() - 1	&&
-	    (withPrivate == 0 ||
-		(entry->priBaseclasses.size() == 0	&&
-		entry->otherPriBaseclasses.size() == 0)))
-	    base->after += first ? "d" : "l";
-	else
-	    base->after += first ? "D" : "L";
-	base->after += "-";
-	firstLine = base->firstLine;
-	first = 0;
+	for(i = 0; i < x.priBaseclasses.size(); ++i)
+	    addBase(direct, new ClassGraph(x.priBaseclasses[i], -1), "-");
+	for(i = 0; i < x.otherPriBaseclasses.size(); ++i)
+	    addBase(direct, new ClassGraph(*(x.otherPriBaseclasses[i]), -1),
+		"-");
 	}
 
-    if(withPrivate)
+    for(i = direct.size() - 1; i >= 0; --i)
 	{
-	for(i = 0; i < entry->priBaseclasses.size(); ++i)
-	    {
-	    base = new ClassGraph(entry->priBaseclasses[i], indent - 1);
-	    base->nextLine = firstLine;
-	    if		// determine, wether this is the first one in child graph
-		(i == entry->priBaseclasses.size() - 1	&&
-		entry->otherPriBaseclasses.size() == 0)
-		base->after += first ? "d" : "l";
-	    else
-		base->after += first ? "D" : "L";
-	    base->after += "-";
-	    base->addBases();
-	    firstLine = base->firstLine;
-	    first = 0;
-	    }
+	ClassGraph *base = direct[i];
+	McString arrow;
+
+	// the last base closes the arrow, the first one starts it
+	if(i == direct.size() - 1)
+	    arrow = i == 0 ? "d" : "l";
+	else
+	    arrow = i == 0 ? "D" : "L";
+	arrow += base->after;
+	base->after = arrow;
 
-	for(i = 0 ; i < entry->otherPriBaseclasses.size(); ++i)
+	if(base->entry)
 	    {
-	    base = new ClassGraph(*(entry->otherPriBaseclasses[i]), indent - 1);
-	    base->nextLine = firstLine;
-	    // determine, wether this is the first one in child graph
-	    if(i == entry->otherPriBaseclasses.size() - 1)
-		base->after += first ? "d" : "l";
-	    else
-		base->after += first ? "D" : "L";
-	    base->after += "-";
-	    firstLine = base->firstLine;
-	    first = 0;
-	    }
-	}
+	    const McDArray<ClassGraph*>& up = basesOf(base->entry);
 
-    if(base)
-	{
-	ClassGraph *cls;
+	    for(j = 0; j < up.size(); ++j)
+		{
+		ClassGraph *line = new ClassGraph(*up[j]);
 
-	for(cls = base->firstLine; cls != base; cls = cls->nextLine)
-	    cls->after += "SP";
-	for(; cls != this; cls = cls->nextLine)
-	    if(cls->indent < indent - 1)
-		cls->after += "||";
+		line->indent -= 1;
+		if(i == direct.size() - 1)
+		    line->after += "SP";
+		else
+		    if(line->indent < -1)
+			line->after += "||";
+		c.bases.append(line);
+		}
+	    }
+	c.bases.append(base);
 	}
 
-    int	min = indent;
-    for(base = firstLine; base; base = base->nextLine)
-	if(base->indent < min)
-	    min = base->indent;
-    for(base = firstLine; base; base = base->nextLine)
-	base->indent -= min;
+    return c.bases;
 }
 
-void ClassGraph::addChilds(const char *strt, bool recursive)
+/* The lines of the direct children of #cls#, with the arrows from #cls#.
+*/
+static void directChildsOf(Entry *cls, McDArray<ClassGraph*>& direct)
 {
-    ClassGraph*	current = this;
+    const EntryExtra& x = cls->constExtra();
     ClassGraph*	child;
     int		i;
     int		first = 1;
     Entry*	last;
 
-    if(withPrivate && entry->priChilds.size())
-	last = entry->priChilds[entry->priChilds.size() - 1];
+    if(withPrivate && x.priChilds.size())
+	last = x.priChilds[x.priChilds.size() - 1];
     else
-	if(entry->proChilds.size())
-	    last = entry->proChilds[entry->proChilds.size() - 1];
+	if(x.proChilds.size())
+	    last = x.proChilds[x.proChilds.size() - 1];
 	else
-	    if(entry->pubChilds.size())
-		last = entry->pubChilds[entry->pubChilds.size() - 1];
+	    if(x.pubChilds.size())
+		last = x.pubChilds[x.pubChilds.size() - 1];
 	    else
 		return;
 
-    for(i = 0; i < entry->pubChilds.size(); ++i)
+    for(i = 0; i < x.pubChilds.size(); ++i)
 	{
-	child = new ClassGraph(entry->pubChilds[i], indent);
-	child->nextLine = current->nextLine;
-	current->nextLine = child;
-	current = child;
-	child->before += strt;
+	child = new ClassGraph(x.pubChilds[i], 0);
 	if(first)
-	    {
-	    if(entry->pubChilds[i] == last)
-		child->before += "^";
-	    else
-		child->before += "|";
-	    }
+	    child->before = x.pubChilds[i] == last ? "^" : "|";
 	else
-	    {
-	    if(entry->pubChilds[i] != last)
-		child->before += "R";
-	    else
-		child->before += "r";
-	    }
+	    child->before = x.pubChilds[i] != last ? "R" : "r";
 	child->before += "_";
+	direct.append(child);
 	first = 0;
 	}
 
-    for(i = 0; i < entry->proChilds.size(); ++i)
+    for(i = 0; i < x.proChilds.size(); ++i)
 	{
-	child = new ClassGraph(entry->proChilds[i], indent);
-	child->nextLine = current->nextLine;
-	current->nextLine = child;
-	current = child;
-	child->before += strt;
+	child = new ClassGraph(x.proChilds[i], 0);
 	if(first)
-	    {
-	    if(entry->proChilds[i] == last)
-		child->before += "^";
-	    else
-		child->before += "|";
-	    }
+	    child->before = x.proChilds[i] == last ? "^" : "|";
 	else
-	    {
-	    if(entry->proChilds[i] != last)
-		child->before += "R";
-	    else
-		child->before += "r";
-	    }
+	    child->before = x.proChilds[i] != last ? "R" : "r";
 	child->before += "-";
+	direct.append(child);
 	first = 0;
 	}
 
     if(withPrivate)
-	{
-	for(i = 0; i < entry->priChilds.size(); ++i)
+	for(i = 0; i < x.priChilds.size(); ++i)
 	    {
-	    child = new ClassGraph(entry->priChilds[i], indent);
-	    child->nextLine = current->nextLine;
-	    current->nextLine = child;
-	    current = child;
-	    child->before += strt;
+	    child = new ClassGraph(x.priChilds[i], 0);
 	    if(first)
-		{
-		if(entry->priChilds[i] == last)
-		    child->before += "^";
-		else
-		    child->before += "|";
-		}
+		child->before = x.priChilds[i] == last ? "^" : "|";
 	    else
-		{
-		if(entry->priChilds[i] != last)
-		    child->before += "R";
-		else
-		    child->before += "r";
-		}
+		child->before = x.priChilds[i] != last ? "R" : "r";
 	    child->before += ".";
+	    direct.append(child);
 	    first = 0;
 	    }
-	}
+}
+
+/* The lines of all classes derived from #cls#. Every child is followed by
+   its own descendants, whose arrows are continued by #||#, or by blanks
+   below the last child.
+*/
+static const McDArray<ClassGraph*>& childsOf(Entry *cls)
+{
+    ClassGraphCache& c = cacheOf(cls);
+
+    if(c.haveChilds)
+	return c.childs;
+    c.haveChilds = true;
+
+    McDArray<ClassGraph*> direct;
+    int i, j;
 
-    if(recursive)
+    directChildsOf(cls, direct);
+    for(i = 0; i < direct.size(); ++i)
 	{
-	McString start(strt);
-	start += "||";
-	ClassGraph *next = this->nextLine;
-	do
+	const McDArray<ClassGraph*>& down = childsOf(direct[i]->entry);
+
+	c.childs.append(direct[i]);
+	for(j = 0; j < down.size(); ++j)
 	    {
-	    child = next;
-	    next  = child->nextLine;
-	    if(child == current)
-		{
-		start = strt;
-		start += "SP";
-		}
-	    child->addChilds(start.c_str(), recursive);
+	    ClassGraph *line = new ClassGraph(*down[j]);
+
+	    line->before = i == direct.size() - 1 ? "SP" : "||";
+	    line->before += down[j]->before;
+	    c.childs.append(line);
 	    }
-	while(child != current);
 	}
+
+    return c.childs;
 }
 
-void ClassGraph::addDirectChilds()
+const ClassGraphLayout& ClassGraphLayout::of(Entry *cls, bool allChilds)
 {
-    addChilds("", 0);
+    ClassGraphCache& c = cacheOf(cls);
+    ClassGraphLayout *g = c.layout[allChilds];
+
+    if(g)
+	return *g;
+    g = c.layout[allChilds] = new ClassGraphLayout;
+
+    const McDArray<ClassGraph*>& up = basesOf(cls);
+    McDArray<ClassGraph*> direct;
+    int	i, min = 0;
+
+    for(i = 0; i < up.size(); ++i)
+	if(up[i]->indent < min)
+	    min = up[i]->indent;
+    for(i = 0; i < up.size(); ++i)
+	{
+	g->lines.append(new ClassGraph(*up[i]));
+	g->lines[i]->indent -= min;
+	}
+
+    g->own = g->lines.size();
+    g->lines.append(new ClassGraph(cls, -min));
+
+    if(!allChilds)
+	directChildsOf(cls, direct);
+    const McDArray<ClassGraph*>& down = allChilds ? childsOf(cls) : direct;
+    for(i = 0; i < down.size(); ++i)
+	{
+	ClassGraph *line = allChilds ? new ClassGraph(*down[i]) : down[i];
+
+	line->indent = -min;
+	g->lines.append(line);
+	}
+
+    return *g;
 }
@@ -31,37 +31,23 @@
 #include "McString.h"
 #include "doc.h"
 
-/// Class graph class
+/// One line of a class graph: a class box and the arrows around it
 class ClassGraph
 {
 public:
     /// constructor for entry
     ClassGraph(Entry *cls, int ind)
-	: nextLine(0), indent(ind), entry(cls)
+	: indent(ind), entry(cls)
     {
-	firstLine = this;
 	assert(cls->isClass());
     }
 
     /// constructor for name
     ClassGraph(const McString& nm, int ind)
-	: nextLine(0), indent(ind), entry(0), name(nm)
+	: indent(ind), entry(0), name(nm)
     {
-	firstLine = this;
     }
 
-    void addAllChilds();
-
-    void addBases();
-
-    void addDirectChilds();
-
-    /// pointer to first line of this class graph
-    ClassGraph*	firstLine;
-
-    /// pointer to next line in this class graph
-    ClassGraph*	nextLine;
-
     /// number of spaces to indent
     int	indent;
 
@@ -94,9 +80,50 @@ public:
 
     /// if no entry to this box is known, take this name instead
     McString name;
+};
+
+/** The class graph of one class: the lines of its base classes, its own
+    line and those of its derived classes.
+
+    The graph of a class is laid out the first time it is asked for and
+    kept with the class, so all writers and all pages share it. It is put
+    together from the base and child lines of the neighbouring classes,
+    which are cached as well, instead of walking the whole hierarchy again
+    for every class.
+*/
+class ClassGraphLayout
+{
+public:
+    /// the graph of #cls# with its direct or, if #allChilds#, all derived classes
+    static const ClassGraphLayout& of(Entry *cls, bool allChilds);
+
+    ~ClassGraphLayout()
+	{
+	for(int i = 0; i < lines.size(); ++i)
+	    delete lines[i];
+	}
+
+    /// number of lines
+    int size() const
+	{
+	return lines.size();
+	}
+
+    /// line #i#, from top to bottom
+    const ClassGraph& operator[](int i) const
+	{
+	return *lines[i];
+	}
+
+    /// index of the line of the class itself
+    int self() const
+	{
+	return own;
+	}
 
 private:
-    void addChilds(const char *strt, bool recursive);
+    McDArray<ClassGraph*> lines;
+    int own;
 };
 
-#endif	
+#endif
@@ -29,6 +29,7 @@
 #include <stdio.h>
 
 #include "doc.h"
+#include "yyread.h"
 
 static const char	*inputString;
 static int		inputPosition;
@@ -49,14 +50,7 @@ static void lineCount()
 
 static int yyread(char *buf, int max_size)
 {
-    int c = 0;
-    while(c < max_size && inputString[inputPosition])
-	{
-	*buf = inputString[inputPosition++];
-	c++;
-	buf++;
-	}
-    return c;
+    return yyReadString(buf, max_size, inputString, inputPosition);
 }
 
 static char nonewline(char c)
@@ -122,7 +116,7 @@ static char nonewline(char c)
 
 <*>^[@\\]"see"[ \t\n]*			{
 					lineCount();
-					current->see.append(new McString);
+					current->extra().see.append(new McString);
 					BEGIN(See);
 					}
 
@@ -148,43 +142,43 @@ static char nonewline(char c)
 
 <*>^[@\\]"param"[ \t\n]*		{
 					lineCount();
-					current->param.append(new McString);
+					current->extra().param.append(new McString);
 					BEGIN(Param);
 					}
 
 <*>^[@\\]"field"[ \t\n]*		{
 					lineCount();
-					current->field.append(new McString);
+					current->extra().field.append(new McString);
 					BEGIN(Field);
 					}
 
 <*>^[@\\]"exception"[ \t\n]*		{
 					lineCount();
-					current->exception.append(new McString);
+					current->extra().exception.append(new McString);
 					BEGIN(Exception);
 					}
 
 <*>^[@\\]"precondition"[ \t\n]*		{
 					lineCount();
-					current->precondition.append(new McString);
+					current->extra().precondition.append(new McString);
 					BEGIN(Precondition);
 					}
 
 <*>^[@\\]"postcondition"[ \t\n]*	{
 					lineCount();
-					current->postcondition.append(new McString);
+					current->extra().postcondition.append(new McString);
 					BEGIN(Postcondition);
 					}
 
 <*>^[@\\]"invariant"[ \t\n]*		{
 					lineCount();
-					current->invariant.append(new McString);
+					current->extra().invariant.append(new McString);
 					BEGIN(Invariant);
 					}
 
 <*>^[@\\]"return"[ \t\n]*		{
 					lineCount();
-					current->retrn.append(new McString);
+					current->extra().retrn.append(new McString);
 					BEGIN(Return);
 					}
 
@@ -249,47 +243,47 @@ static char nonewline(char c)
 					}
 
 <Author>.				{
-					current->author += *yytext;
+					current->extra().author += *yytext;
 					}
 
 <Version>.				{
-					current->version += *yytext;
+					current->extra().version += *yytext;
 					}
 
 <Deprecated>.				{
-					current->deprecated += *yytext;
+					current->extra().deprecated += *yytext;
 					}
 
 <Since>.				{
-					current->since += *yytext;
+					current->extra().since += *yytext;
 					}
 
 <See>.					{
-					*(current->see.last()) += *yytext;
+					*(current->extra().see.last()) += *yytext;
 					}
 
 <Param>.				{
-					*(current->param.last()) += *yytext;
+					*(current->extra().param.last()) += *yytext;
 					}
 
 <Field>.				{
-					*(current->field.last()) += *yytext;
+					*(current->extra().field.last()) += *yytext;
 					}
 
 <Exception>.				{
-					*(current->exception.last()) += *yytext;
+					*(current->extra().exception.last()) += *yytext;
 					}
 
 <Precondition>.				{
-					*(current->precondition.last()) += *yytext;
+					*(current->extra().precondition.last()) += *yytext;
 					}
 
 <Postcondition>.			{
-					*(current->postcondition.last()) += *yytext;
+					*(current->extra().postcondition.last()) += *yytext;
 					}
 
 <Invariant>.				{
-					*(current->invariant.last()) += *yytext;
+					*(current->extra().invariant.last()) += *yytext;
 					}
 
 <Memo>.					{
@@ -297,51 +291,51 @@ static char nonewline(char c)
 					}
 
 <Return>.				{
-					*(current->retrn.last()) += *yytext;
+					*(current->extra().retrn.last()) += *yytext;
 					}
 
 <Author>\n[ \t\n]*			{
-					current->author += '\n';
+					current->extra().author += '\n';
 					}
 
 <Version>\n[ \t\n]*			{
-					current->version += '\n';
+					current->extra().version += '\n';
 					}
 
 <Deprecated>\n[ \t\n]*			{
-					current->deprecated += '\n';
+					current->extra().deprecated += '\n';
 					}
 
 <Since>\n[ \t\n]*			{
-					current->since += '\n';
+					current->extra().since += '\n';
 					}
 
 <See>\n[ \t\n]*				{
-					*(current->see.last()) += '\n';
+					*(current->extra().see.last()) += '\n';
 					}
 
 <Param>\n[ \t\n]*			{
-					*(current->param.last()) += '\n';
+					*(current->extra().param.last()) += '\n';
 					}
 
 <Field>\n[ \t\n]*			{
-					*(current->field.last()) += '\n';
+					*(current->extra().field.last()) += '\n';
 					}
 
 <Exception>\n[ \t\n]*			{
-					*(current->exception.last()) += '\n';
+					*(current->extra().exception.last()) += '\n';
 					}
 
 <Precondition>\n[ \t\n]*	{
-					*(current->precondition.last()) += '\n';
+					*(current->extra().precondition.last()) += '\n';
 					}
 
 <Postcondition>\n[ \t\n]*   {
-					*(current->postcondition.last()) += '\n';
+					*(current->extra().postcondition.last()) += '\n';
 					}
 
 <Invariant>\n[ \t\n]*	    {
-					*(current->invariant.last()) += '\n';
+					*(current->extra().invariant.last()) += '\n';
 					}
 
 <Memo>\n[ \t\n]*			{
@@ -349,7 +343,7 @@ static char nonewline(char c)
 					}
 
 <Return>\n[ \t\n]*			{
-					*(current->retrn.last()) += '\n';
+					*(current->extra().retrn.last()) += '\n';
 					}
 
 <Filename>.*				{
@@ -27,6 +27,7 @@
 
 #include "McDArray.h"
 #include "doc.h"
+#include "yyread.h"
 
 static const char*	inputString;
 static int		inputPosition;
@@ -42,6 +43,7 @@ bool			commentExtn    			= false;
 McString		configFile			("doc++.conf");
 bool			HTMLsyntax     			= false;
 McString		fileList;
+bool			fileListNul			= false;
 bool			java           			= false;
 bool			php           			= false;
 bool			noDefines			= false;
@@ -57,7 +59,10 @@ bool			idl				= false;
 bool			doDOCBOOK			= false;
 bool			doDOCBOOKXML			= false;
 bool			doXML				= false;
+McString		dbFile;
 McDArray<McString *>	inputFiles;
+McDArray<McString *>	includeFiles;
+McDArray<McString *>	excludeFiles;
 
 bool			withTables     			= false;
 bool			withBorders    			= false;
@@ -67,6 +72,8 @@ bool			showFilenames  			= false;
 bool			showFilePath   			= false;
 bool			noGifs         			= false;
 bool			forceGifs      			= false;
+bool			useMathML      			= false;
+bool			streamHtml     			= false;
 bool			showInherited  			= true;
 bool			javaGraphs     			= true;
 bool			trivialGraphs  			= false;
@@ -98,15 +105,7 @@ bool			hideIndexOnEverySection		= false;
 
 static int yyread(char *buf, int max_size)
 {
-    int c = 0;
-
-    while(c < max_size && inputString[inputPosition])
-	{
-	*buf = inputString[inputPosition++];
-	c++;
-	buf++;
-	}
-    return c;
+    return yyReadString(buf, max_size, inputString, inputPosition);
 }
 
 %}
@@ -223,11 +222,26 @@ static int yyread(char *buf, int max_size)
 			BEGIN(Boolean);
 			}
 
+<Start>"database"[ \t]*	{
+			string_data = &dbFile;
+			BEGIN(String);
+			}
+
 <Start>"inputFiles"[ \t]*	{
 			list_data = &inputFiles;
 			BEGIN(List);
 			}
 
+<Start>"includeFiles"[ \t]*	{
+			list_data = &includeFiles;
+			BEGIN(List);
+			}
+
+<Start>"excludeFiles"[ \t]*	{
+			list_data = &excludeFiles;
+			BEGIN(List);
+			}
+
 <Start>"useTables"[ \t]*	{
 			boolean_data = &withTables;
 			BEGIN(Boolean);
@@ -268,6 +282,16 @@ static int yyread(char *buf, int max_size)
 			BEGIN(Boolean);
 			}
 
+<Start>"useMathML"[ \t]*	{
+			boolean_data = &useMathML;
+			BEGIN(Boolean);
+			}
+
+<Start>"streamHtml"[ \t]*	{
+			boolean_data = &streamHtml;
+			BEGIN(Boolean);
+			}
+
 <Start>"noInheritedMembers"[ \t]*	{
 			reverseValue = true;
 			boolean_data = &showInherited;
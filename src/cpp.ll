@@ -29,11 +29,17 @@
 #include <iostream>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "doc.h"
+#include "stats.h"
+#include "yyread.h"
 
 static const char*	inputString;
+static int		inputLength;
 static int		inputPosition;
+static int		inputBase;	// offset of flex' buffer in inputString
+static bool		inputNewline;	// a newline is still to be read
 static int		lastCContext;
 static int		protection = PUBL;
 static int		curlyBracketCount = 0;
@@ -109,18 +115,38 @@ static char nonewline(char c)
 }
 
 #undef	YY_INPUT
-#define	YY_INPUT(buf, result, max_size) result = yyread(buf, max_size);
+#define	YY_INPUT(buf, result, max_size) \
+    { \
+    inputBase = inputPosition - (int)((buf) - YY_CURRENT_BUFFER->yy_ch_buf); \
+    result = yyread(buf, max_size); \
+    }
+
+/* Class bodies are not copied, the entries keep where they are in the
+   input. #INPUT_AT(p)# is the position in #inputString# of #p#, a
+   pointer into the text flex has read.
+*/
+#define	INPUT_AT(p) inputAt(p, YY_CURRENT_BUFFER->yy_ch_buf)
+
+static const char *inputAt(const char *p, const char *buffer)
+{
+    int offset = inputBase + (int)(p - buffer);
+
+    // the newline read after a class body is not in the input
+    return inputString + (offset < inputLength ? offset : inputLength);
+}
 
 static int yyread(char *buf, int max_size)
 {
-    int c = 0;
-    while(c < max_size && inputString[inputPosition])
+    int n = yyReadSpan(buf, max_size, inputString, inputLength,
+	inputPosition);
+
+    if(n == 0 && inputNewline)
 	{
-	*buf = inputString[inputPosition++];
-	c++;
-	buf++;
+	inputNewline = false;
+	*buf = '\n';
+	n = 1;
 	}
-    return c;
+    return n;
 }
 
 static int addParamDoc()
@@ -214,6 +240,7 @@ static int addParamDoc()
 					for(i = 0; yytext[i + 1] != 6; i++)
 					    yyFileName[i] = yytext[i + 1];
 					yyFileName[i] = 0;
+					costParse(yyFileName);
 					}
 
 <*>"'"[{}]"'"				{
@@ -654,7 +681,7 @@ static int addParamDoc()
 
 <Friend>[^;\n]+				{
 					current->clear();
-					current_root->friends.append(new McString(yytext));
+					current_root->extra().friends.append(new McString(yytext));
 					}
 
 <Friend>[;\n]				{
@@ -705,31 +732,20 @@ static int addParamDoc()
 					current->type += *yytext;
 					}
 
-<Curly>[^\n{}"/]*			{
-					current->program += yytext;
-					}
-
-<Curly>"//".*				{
-					current->program += yytext;
-					}
-
-<Curly>\"[^\n"]*]\"			{
-					current->program += yytext;
-					}
+<Curly>[^\n{}"/]*
+<Curly>"//".*
+<Curly>\"[^\n"]*]\"
 
 <Curly>"/*"\**[ \t]*			{
-					current->program += yytext;
 					BEGIN(Comment);
 					}
 
 <Curly>"/*"\**[ \t]*\n			{
-					current->program += yytext;
 					++yyLineNr;
 					BEGIN(Comment);
 					}
 
 <Curly>"{"				{
-					current->program += yytext;
 					++curlyBracketCount;
 					++innerCurlyCount;
 					}
@@ -747,11 +763,12 @@ static int addParamDoc()
 						    delete namespace_table[i]->name;
 						    namespace_table.remove(i);
 						    }
-					    current->program += yytext;
 					    --innerCurlyCount;
 					    }
 					else
 					    {
+					    current->bodyLength = INPUT_AT(yytext) -
+						current->body;
 					    current_root->addSubEntry(current);
 					    current->file = yyFileName;
 					    last = current;
@@ -762,13 +779,10 @@ static int addParamDoc()
 					}
 
 <Curly>\n				{
-					current->program += yytext;
 					yyLineNr++;
 					}
 
-<Curly>.				{
-					current->program += yytext;
-					}
+<Curly>.
 
 <FindMembers>"("			{
 					current->args = yytext;
@@ -1063,6 +1077,8 @@ static int addParamDoc()
 #endif
 					current->file = yyFileName;
 					current->startLine = yyLineNr;
+					current->body = INPUT_AT(yytext + yyleng);
+					current->bodyLength = -1;
 					++curlyBracketCount;
 					innerCurlyCount = 0;
 					BEGIN(Curly);
@@ -1104,7 +1120,7 @@ static int addParamDoc()
 					}
 
 <Bases>[a-z_A-Z*.<>0-9:]+		{
-					current->extends.append(
+					current->extra().extends.append(
 					    new McString(yytext));
 					current->args += ' ';
 					current->args += yytext;
@@ -1115,17 +1131,13 @@ static int addParamDoc()
 					}
 
 <Comment>\n				{
-					current->program += yytext;
 					yyLineNr++;
 					}
 
 <Comment>"//"
-<Comment>.				{
-					current->program += yytext;
-					}
+<Comment>.
 
 <Comment>.*"*/"				{
-					current->program += yytext;
 					BEGIN(Curly);
 					}
 
@@ -1202,7 +1214,7 @@ static int addParamDoc()
 					else
 					    addNamespace(current_root);
 					tmp += yytext;
-					Entry *find = findEntry(current_root->sub, tmp.c_str(), NAMESPACE_SEC);
+					Entry *find = findEntry(current_root, tmp.c_str(), NAMESPACE_SEC);
 					if(find)
 					    {
 					    current_root = find;
@@ -1242,7 +1254,7 @@ static int addParamDoc()
 					}
 
 <UsingNamespace>[a-z_A-Z0-9]+("::"[a-z_A-Z0-9]+)*	{
-					Entry *find = findEntry(current_root->sub, yytext, NAMESPACE_SEC);
+					Entry *find = findEntry(current_root, yytext, NAMESPACE_SEC);
 					if(find)
 					    {
 					    // add the namespace to the lookup
@@ -1330,32 +1342,28 @@ static int addParamDoc()
 					lineCount();
 					current->file = yyFileName;
 					current->startLine = yyLineNr;
+					current->body = INPUT_AT(yytext + yyleng);
+					current->bodyLength = -1;
 					innerCurlyCount = 0;
 					BEGIN(SubDoc);
 					}
 
 <SubDoc>"/*"				{
-					current->program += yytext;
 					BEGIN(SubDocComment);
 					}
 
 <SubDoc>"//"				{
-					current->program += yytext;
 					BEGIN(SubDocCppComment);
 					}
 
-<SubDoc>.				{
-					current->program += *yytext;
-					}
+<SubDoc>.
 
 <SubDoc>\n				{
-					current->program += *yytext;
 					++yyLineNr;
 					}
 
 <SubDoc>("//@{".*\n)|("/*@{"[^*]*\*+"/") {
 					lineCount();
-					current->program += yytext;
 					++curlyBracketCount;
 					++innerCurlyCount;
 					}
@@ -1365,15 +1373,14 @@ static int addParamDoc()
 					if(curlyBracketCount > 0)
 					    --curlyBracketCount;
 					if(innerCurlyCount > 0)
-					    {
-					    current->program += yytext;
 					    --innerCurlyCount;
-					    }
 					else
 					    {
 #ifdef DEBUG
 					    debug("found explicit subentry");
 #endif
+					    current->bodyLength = INPUT_AT(yytext) -
+						current->body;
 					    current->docify = true;
 					    current_root->addSubEntry(current);
 					    last = current;
@@ -1383,34 +1390,21 @@ static int addParamDoc()
 					    }
 					}
 
-<SubDocComment,SubDocCppComment>"/*"	{
-					current->program += yytext;
-					}
-
-<SubDocComment,SubDocCppComment>"//"	{
-					current->program += yytext;
-					}
-
-<SubDocComment>.			{
-					current->program += yytext;
-					}
+<SubDocComment,SubDocCppComment>"/*"
+<SubDocComment,SubDocCppComment>"//"
+<SubDocComment>.
 
 <SubDocComment>\n			{
-					current->program += yytext;
 					++yyLineNr;
 					}
 
 <SubDocComment>"*/"			{
-					current->program += yytext;
 					BEGIN(SubDoc);
 					}
 
-<SubDocCppComment>.			{
-					current->program += yytext;
-					}
+<SubDocCppComment>.
 
 <SubDocCppComment>\n			{
-					current->program += yytext;
 					++yyLineNr;
 					BEGIN(SubDoc);
 					}
@@ -1444,7 +1438,10 @@ static int addParamDoc()
 void callcppYYlex()
 {
     cppYYlex();
-    if(current->name.length() || current->program.length() ||
+    // a body still open runs to the end of the input
+    if(current->bodyLength < 0)
+	current->bodyLength = inputString + inputLength - current->body;
+    if(current->name.length() || current->bodyLength > 0 ||
 	current->memo.length() || current->doc.length())
 	{
 	current->docify = true;
@@ -1458,29 +1455,73 @@ void callcppYYlex()
 	}
 }
 
+/* Without --all only members with a doc comment are kept. A class body
+   without any doc comment marker and without friends, whose last
+   declaration is complete, can not give such a member and is not parsed.
+*/
+static bool mayHaveDocs(const char *body, int length)
+{
+    const char *end = body + length;
+    const char *p;
+
+    // the body lies within the input, which ends with a 0
+    for(p = (const char *)memchr(body, '/', length); p;
+	p = (const char *)memchr(p + 1, '/', end - p - 1))
+	if(p[1] == '/')
+	    {
+	    if(commentExtn || p[2] == '/' || p[2] == '@' ||
+		strncmp(p + 2, "{{{", 3) == 0)
+		return true;
+	    }
+	else
+	    if(p[1] == '*' && (p[2] == '*' || p[2] == '@' ||
+		strncmp(p + 2, "{{{", 3) == 0))
+		return true;
+
+    for(p = (const char *)memchr(body, 'f', length); p;
+	p = (const char *)memchr(p + 1, 'f', end - p - 1))
+	if(end - p >= 6 && strncmp(p, "friend", 6) == 0)
+	    return true;
+
+    // a declaration left open is added as if it had been documented
+    for(p = end - 1; p >= body && isspace(*p); p--)
+	;
+    return p >= body && *p != ';';
+}
+
 void parseCppClasses(Entry *rt)
 {
     Entry *cr;
+    int i;
 
     if(rt == 0)
 	return;
-    for(cr = rt->sub; cr; cr = cr->next)
+    // scanning a class may append to rt, so do not keep the size
+    for(i = 0; i < rt->subEntries.size(); i++)
 	{
+	cr = rt->subEntries[i];
 #ifdef DEBUG
 	if(verb)
 	    {
 	    printf("Scanning `%s %s%s'", cr->type.c_str(), cr->name.c_str(),
 		cr->args.c_str());
-	    if(cr->program.length())
+	    if(cr->bodyLength)
 		printf("...");
 	    printf("\n");
 	    }
 #endif
-	if(cr->program.length() > 0)
+	if(cr->bodyLength > 0 && onlyDocs &&
+	    !mayHaveDocs(cr->body, cr->bodyLength))
+	    {
+	    docStats.skippedBodies++;
+	    cr->bodyLength = 0;
+	    }
+	if(cr->bodyLength > 0)
 	    {
-	    cr->program += '\n';
-	    inputString = cr->program.c_str();
+	    inputString = cr->body;
+	    inputLength = cr->bodyLength;
 	    inputPosition = 0;
+	    inputNewline = true;
 	    cppYYrestart(cppYYin);
 	    BEGIN(FindMembers);
 	    current_root = cr;
@@ -1491,9 +1532,14 @@ void parseCppClasses(Entry *rt)
 		current->protection = protection = PRIV;
 	    else
 		current->protection = protection = PUBL;
+	    traceBegin("class", cr->name.c_str(), cr->file.c_str());
+	    costParse(yyFileName);
 	    callcppYYlex();
-	    cr->program.clear();
+	    costParse(0);
+	    traceEnd();
 	    }
+	cr->body = 0;
+	cr->bodyLength = 0;
         parseCppClasses(cr);
 	}
     parseDoc(rt);
@@ -1501,27 +1547,22 @@ void parseCppClasses(Entry *rt)
 
 void buildFullName(Entry *entry)
 {
-    Entry *tmp;
+    int i;
 
-    for(tmp = entry; tmp; tmp = tmp->next)
-	{
-	tmp->makeFullName();
-	buildFullName(tmp->sub);
-	}
+    entry->makeFullName();
+    for(i = 0; i < entry->subEntries.size(); i++)
+	buildFullName(entry->subEntries[i]);
 }
 
 void removeNotDocified(Entry *entry)
 {
-    Entry *index = entry, *tmp;
+    int i;
 
-    for(; index; index = tmp)
-	{
-	if(index->sub)
-	    removeNotDocified(index->sub);
-	tmp = index->next;
-	if((!index->docify || !MAKE_DOC(index)) && index != root)
-	    index->parent->removeSub(index);
-	}
+    // backwards, so that removing an entry does not move those still to come
+    for(i = entry->subEntries.size() - 1; i >= 0; i--)
+	removeNotDocified(entry->subEntries[i]);
+    if((!entry->docify || !MAKE_DOC(entry)) && entry != root)
+	entry->parent->removeSub(entry);
 }
 
 void parseCpp(Entry *rt)
@@ -1535,12 +1576,16 @@ void parseCpp(Entry *rt)
     last = current;
 
     inputString = rt->program.c_str();
+    inputLength = strlen(inputString);
     inputPosition = 0;
+    inputNewline = false;
     cppYYrestart(cppYYin);
     BEGIN(FindMembers);
     callcppYYlex();
-    rt->program.clear();
+    costParse(0);
+    // the bodies of the classes point into the input
     parseCppClasses(rt);
+    rt->program.clear();
     removeNotDocified(rt);
     buildFullName(rt);
 
@@ -333,6 +333,12 @@ public:
 	    if(cpy[i].status == DataHashTable_Element<HashItem, Info>::USED)
 		add(cpy[i].item, cpy[i].info);
 	}
+
+    /// account the memory of the table to the McAllocTag #tag#
+    void setAllocTag(int tag)
+	{
+	element.setTag(tag);
+	}
     //@}
 
     /**@name Miscallaneous */
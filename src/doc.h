@@ -50,6 +50,7 @@ extern bool			commentExtn;		// --c-comments
 extern McString			configFile;		// --config FILE
 extern bool			HTMLsyntax;		// --html
 extern McString			fileList;		// --input FILE
+extern bool			fileListNul;		// --input0 FILE
 extern bool			java;			// --java
 extern bool			php;			// --php
 extern bool			trivialGraphs;		// --trivial-graphs
@@ -64,8 +65,11 @@ extern bool			verb;			// --verbose
 extern bool			idl;
 extern bool			doDOCBOOK;
 extern bool			doDOCBOOKXML;
+extern McString			dbFile;			// --db FILE
 extern bool			scanIncludes;		// --scan-includes
 extern McDArray<McString *>	inputFiles;
+extern McDArray<McString *>	includeFiles;		// --include PATTERN
+extern McDArray<McString *>	excludeFiles;		// --exclude PATTERN
 
 extern bool			withTables;		// --tables
 extern bool			withBorders;		// --tables-borders
@@ -75,6 +79,8 @@ extern bool			showFilenames;		// --filenames
 extern bool			showFilePath;		// --filenames-path
 extern bool			noGifs;			// --no-gifs
 extern bool			forceGifs;		// --gifs
+extern bool			useMathML;		// --mathml
+extern bool			streamHtml;		// --streaming
 extern bool			showInherited;		// --no-inherited
 extern bool			javaGraphs;		// --no-java-graphs
 extern bool			alwaysPrintDocSection;	// --no-members
@@ -134,6 +140,90 @@ enum LANGUAGE
     LANG_PHP		= 'p'
 };
 
+class Entry;
+struct InheritedMembers;
+struct ClassGraphCache;
+
+/// free the member lists html.cc keeps with an inherited class
+extern void freeInheritedMembers(InheritedMembers *m);
+
+/// free the class graph lines classgraph.cc keeps with a class
+extern void freeClassGraphCache(ClassGraphCache *c);
+
+/** Fields of an #Entry# that most entries leave empty: the tagged
+    documentation, the class relations and the Java and PHP specific data.
+    They are kept apart so that an entry without them stays small.
+*/
+struct EntryExtra
+{
+    EntryExtra() : inHtml(false), inherited(0), graph(0) {}
+    ~EntryExtra();
+
+    /// Author info
+    McString		author;
+
+    /// Version info
+    McString		version;
+
+    /// "Deprecated" info
+    McString		deprecated;
+
+    /// "Since" info
+    McString		since;
+
+    /// Array of "see also" notations
+    McDArray<McString*> see;
+
+    /// Array of parameters documentation
+    McDArray<McString*> param;
+
+    /// Array of fields documentation
+    McDArray<McString*> field;
+
+    /// Array of thrown exceptions documentation
+    McDArray<McString*> exception;
+
+    /// Array of return values documentation
+    McDArray<McString*> retrn;
+
+    /// Array of preconditions documentation
+    McDArray<McString*> precondition;
+
+    /// Array of postconditions documentation
+    McDArray<McString*> postcondition;
+
+    /// Array of invariants documentation
+    McDArray<McString*> invariant;
+
+    /// Array of friends' documentation
+    McDArray<McString*> friends;
+
+    McDArray<Entry*>	pubChilds;
+    McDArray<Entry*>	proChilds;
+    McDArray<Entry*>	priChilds;
+    McDArray<Entry*>	baseclasses;		// to be removed !!!
+    McDArray<Entry*>	pubBaseclasses;
+    McDArray<Entry*>	proBaseclasses;
+    McDArray<Entry*>	priBaseclasses;
+
+    /// base classes that are not documented
+    McDArray<McString*>	otherPubBaseclasses;
+    McDArray<McString*>	otherProBaseclasses;
+    McDArray<McString*>	otherPriBaseclasses;
+    McDArray<McString*>	implements;
+    McDArray<McString*>	extends;
+    McDArray<McString*>	import;
+
+    /// true once the tags above have been converted to HTML in place
+    bool		inHtml;
+
+    /// members of this class as listed where it is inherited, see html.cc
+    InheritedMembers*	inherited;
+
+    /// class graph lines of this class, see classgraph.cc
+    ClassGraphCache*	graph;
+};
+
 /** An entry in the documentation database.
 
     This class is the primary data item created when scanning source. Each
@@ -146,6 +236,8 @@ public:
     /// Constructor
     Entry();
 
+    ~Entry();
+
     /** Adds `name' to the list of base classes and to the list of `name''s
 	subclasses.
     */
@@ -192,32 +284,62 @@ public:
     /// Remove the specified subentry
     void removeSub(Entry *);
 
+    /// True if any of the rarely needed fields has been set
+    bool hasExtra() const
+	{
+	return ext != 0;
+	}
+
+    /// The rarely needed fields for changing them, created on first use
+    EntryExtra& extra();
+
+    /// The rarely needed fields for reading, all empty if never set
+    const EntryExtra& constExtra() const
+	{
+	return ext ? *ext : noExtra;
+	}
+
+    /* The fields every traversal touches come first, so that a walk over
+       the tree reads as few cache lines per entry as possible.
+    */
+
     /// Entry type (class, function, etc.)
     unsigned short	section;
 
-    /// True if this entry can be tied to a class
-    bool		general;
-
     /// Access right (pulic, protected or private)
     char		protection;
 
+    /// True if this entry can be tied to a class
+    bool		general;
+
     /// True if this entry will get it's own HTML page
     bool		ownPage;
 
-    /// The parent of this entry
-    Entry*		parent;
+    /// Indicates if the method is pure virtual
+    bool		pureVirtual;
+
+    /// Is this entry going to be docified?
+    bool		docify;
 
-    /// The next entry at this level
-    Entry*		next;
+    bool		fromUnknownPackage;
 
-    /// Linked list of sub-entries at this level
-    Entry*		sub;
+    int			line;
+    int			number;
+    int			subnumber;
 
-   /// Indicates if the method is pure virtual
-   bool			pureVirtual;
+    /// The parent of this entry
+    Entry*		parent;
 
-    /// Return type of the entry
-    McString		type;
+    /// Sub-entries in the order they were added
+    McDArray<Entry*>	subEntries;
+
+    /** Sub-entries sorted by name once #makeSubList()# has been called, in
+	the order they were added before.
+    */
+    const McDArray<Entry*>& sublist() const
+	{
+	return sorted ? sortedSubs : subEntries;
+	}
 
     /// Name of the entry
     McString		name;
@@ -225,6 +347,9 @@ public:
     /// Full name of the entry (including the inheritance)
     McString		fullName;
 
+    /// Return type of the entry
+    McString		type;
+
     /// Arguments for the entry
     McString		args;
 
@@ -234,92 +359,45 @@ public:
     /// Main documentation
     McString		doc;
 
-    McString		program;
-
-    /// Author info
-    McString		author;
-
-    /// Version info
-    McString		version;
-
-    /// "Deprecated" info
-    McString		deprecated;
-
-    /// "Since" info
-    McString		since;
-
-    /// Array of "see also" notations
-    McDArray<McString*> see;
-
-    /// Array of parameters documentation
-    McDArray<McString*> param;
-
-    /// Array of fields documentation
-    McDArray<McString*> field;
-
-    /// Array of thrown exceptions documentation
-    McDArray<McString*> exception;
-
-    /// Array of return values documentation
-    McDArray<McString*> retrn;
-
-    /// Array of preconditions documentation
-    McDArray<McString*> precondition;
-
-    /// Array of postconditions documentation
-    McDArray<McString*> postcondition;
-
-    /// Array of invariants documentation
-    McDArray<McString*> invariant;
-
-    /// Array of friends' documentation
-    McDArray<McString*> friends;
-
-    /// Array of sub-entries to this one
-    McDArray<Entry*>	sublist;
-
-    McDArray<Entry*>	pubChilds;
-    McDArray<Entry*>	proChilds;
-    McDArray<Entry*>	priChilds;
-    McDArray<Entry*>	baseclasses;		// to be removed !!!
-    McDArray<Entry*>	pubBaseclasses;
-    McDArray<Entry*>	proBaseclasses;
-    McDArray<Entry*>	priBaseclasses;
-
-    /// base classes that are not documented
-    McDArray<McString*>	otherPubBaseclasses;
-    McDArray<McString*>	otherProBaseclasses;
-    McDArray<McString*>	otherPriBaseclasses;
-    McDArray<McString*>	implements;
-    McDArray<McString*>	extends;
-    McDArray<McString*>	import;
-    Entry*		currentParent;		// for temporary use in TeX output
+    // These are the html-ified strings
+    char*		htype;
+    char*		hname;
+    char*		hargs;
+    char*		hmemo;
+    char*		hsee;
+    char*		hdoc;
 
     /** If this member overrides something from a baseclass, this points to
         the overridden member.
     */
     Entry*		override;
 
+    Entry*		currentParent;		// for temporary use in TeX output
+
+    McString		file;
     McString		fileName;
     int			startLine;
 
-    // These are the html-ified strings
-    char*		htype;
-    char*		hname;
-    char*		hargs;
-    char*		hmemo;
-    char*		hsee;
-    char*		hdoc;
+    McString		program;
 
-    McString		file;
-    int			line;
-    int			number;
-    int			subnumber;
+    /** Body of a class or of a group of members found by the C++ scanner,
+        #bodyLength# characters at #body#. It points into the input and is
+        only valid until the scanner is done.
+    */
+    const char*		body;
+    int			bodyLength;
 
-    /// Is this entry going to be docified?
-    bool		docify;
+private:
+    McDArray<Entry*>	sortedSubs;
+    bool		sorted;
 
-    bool		fromUnknownPackage;
+    EntryExtra*		ext;
+
+    static const EntryExtra noExtra;
+
+    // not copyable, #ext# is owned
+    Entry(const Entry&);
+    Entry& operator=(const Entry&);
 };
 
 struct namespace_entry {
@@ -348,45 +426,52 @@ extern Entry*	getRefEntry(const char *name, Entry *entry);
 extern Entry*	getRefEntry(McString &name, Entry *entry);
 extern void	makeSubLists(Entry *rt);
 extern void	entry2link(McString& u, Entry *ref,const char *linkname = 0);
-extern Entry*	findEntry(Entry *start, const char *fullName, unsigned short section);
+extern Entry*	findEntry(Entry *parent, const char *fullName, unsigned short section);
 extern void	setupLanguageHash();
 extern void	mergeEntries(Entry *root);
 extern int	getNumChildren(Entry *tp);
 extern void	checkPackages(Entry *tp);
 extern void	reNumber(Entry *tp);
 extern bool	relevantClassGraphs(Entry *tmp);
+extern void	entryTableStats();
+extern void	readfileStats();
+extern void	htmlStats();
 
 extern void	readfile(McString *in, const char *file, int startLine,
 		    const McString& directory = "", int scanSubDirs = 0);
 
-#define	HAS_BASES(entry)			\
-	(entry->otherPubBaseclasses.size() ||	\
-	entry->otherProBaseclasses.size() ||	\
-	entry->pubBaseclasses.size() ||		\
-	entry->proBaseclasses.size())
+/// number of files asked for with #prefetchFile()# ahead of the one read
+#define	PREFETCH_AHEAD	16
+extern void	prefetchFile(const char *path);
+
+#define	HAS_BASES(entry)				\
+	(entry->constExtra().otherPubBaseclasses.size() ||	\
+	entry->constExtra().otherProBaseclasses.size() ||	\
+	entry->constExtra().pubBaseclasses.size() ||		\
+	entry->constExtra().proBaseclasses.size())
 
 #define	MAKE_DOC(entry)						\
 	((entry->name.length() > 0 ||				\
 	entry->type.length() > 0 ||				\
 	entry->args.length() > 2 ||				\
-	entry->sub != 0 ||					\
-	entry->see.size() > 0 ||				\
-	entry->author.length() > 0 ||				\
-	entry->version.length() > 0 ||				\
-	entry->deprecated.length() > 0 ||			\
-	entry->since.length() > 0 ||				\
-	entry->param.size() > 0 ||				\
-	entry->field.size() > 0 ||				\
-	entry->retrn.size() > 0 ||				\
-	entry->exception.size() > 0 ||				\
-	entry->precondition.size() > 0 ||			\
-	entry->postcondition.size() > 0 ||			\
-	entry->invariant.size() > 0 ||				\
-	entry->friends.size() > 0 ||				\
+	entry->subEntries.size() > 0 ||				\
+	entry->constExtra().see.size() > 0 ||			\
+	entry->constExtra().author.length() > 0 ||		\
+	entry->constExtra().version.length() > 0 ||		\
+	entry->constExtra().deprecated.length() > 0 ||		\
+	entry->constExtra().since.length() > 0 ||		\
+	entry->constExtra().param.size() > 0 ||			\
+	entry->constExtra().field.size() > 0 ||			\
+	entry->constExtra().retrn.size() > 0 ||			\
+	entry->constExtra().exception.size() > 0 ||		\
+	entry->constExtra().precondition.size() > 0 ||		\
+	entry->constExtra().postcondition.size() > 0 ||		\
+	entry->constExtra().invariant.size() > 0 ||		\
+	entry->constExtra().friends.size() > 0 ||		\
 	entry->doc.length() > 0 ||				\
-	entry->proChilds.size() > 0 ||				\
-	entry->pubChilds.size() > 0 ||				\
-	(entry->priChilds.size() > 0 && withPrivate) ||		\
+	entry->constExtra().proChilds.size() > 0 ||		\
+	entry->constExtra().pubChilds.size() > 0 ||		\
+	(entry->constExtra().priChilds.size() > 0 && withPrivate) ||	\
 	(entry->parent != 0 && entry->parent->parent == 0) ||	\
 	HAS_BASES(entry)) && (!(entry->fromUnknownPackage)))
 
@@ -30,6 +30,7 @@
 #include <string.h>
 
 #include "doc.h"
+#include "yyread.h"
 
 #define YY_DECL int yylex()
 
@@ -45,15 +46,7 @@ static PROTECTION baseProtection = PRIV;
 
 static int yyread(char *buf, int max_size)
 {
-    int c = 0;
-
-    while(c < max_size && inStr[inPos])
-	{
-	*buf = inStr[inPos++];
-	c++;
-	buf++;
-	}
-    return c;
+    return yyReadString(buf, max_size, inStr, inPos);
 }
 
 extern "C" {
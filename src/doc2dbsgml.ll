@@ -29,7 +29,9 @@
 #include <string.h>
 
 #include "classgraph.h"
+#include "McScan.h"
 #include "doc.h"
+#include "yyread.h"
 
 #define YY_DECL int yylex()
 
@@ -60,14 +62,7 @@ static int	tabFlag	      = 0;
 
 static int yyread(char *buf, int max_size)
 {
-    int c = 0;
-    while(c < max_size && inStr[inPos])
-	{
-	*buf = inStr[inPos++];
-	c++;
-	buf++;
-	}
-    return c;
+    return yyReadString(buf, max_size, inStr, inPos);
 }
 
 extern "C" {
@@ -209,6 +204,10 @@ static void closeVerbMode()
 			fprintf(out, "$\\hat{\\;}$");
 			}
 
+<Code>[^#$%&<>\\^_{} ~\x06]+	{
+			fwrite(yytext, 1, yyleng, out);
+			}
+
 <HTMLlist,TeXlist,Ref,LVerb,Verb,Code>(.|\n)	{
 			fprintf(out, "%c", *yytext);
 			}
@@ -298,6 +297,10 @@ static void closeVerbMode()
 			BEGIN(0);
 			}
 
+[^#$%&<>\\^_~\x06]+	{
+			fwrite(yytext, 1, yyleng, out);
+			}
+
 .			{
 			fprintf(out, "%s", yytext);
 			}
@@ -396,6 +399,10 @@ static void closeVerbMode()
 			fprintf(out, "$\\backslash$");
 			}
 
+<HTML>[^#$%&<>\\^_{}\x06]+	{
+			fwrite(yytext, 1, yyleng, out);
+			}
+
 <HTML>.			{
 			fprintf(out, "%s", yytext);
 			}
@@ -785,6 +792,37 @@ void dblisting(char *str)
     finitDocbook();
 }
 
+// Characters the rules of Code, INITIAL and HTML act upon, the rules
+// copy the runs of all others as they are
+static const McScanSet codeSpecial("#$%&<>\\^_{} ~\006");
+static const McScanSet texSpecial("#$%&<>\\^_~\006");
+static const McScanSet htmlSpecial("#$%&<>\\^_{}\006");
+
+/* Scans #inStr# from #inPos# on in start condition #state#. Text without
+   any character in #special# is written as it is.
+*/
+static void scanText(int state, const McScanSet& special)
+{
+    if(*mcScan(inStr + inPos, special) == '\0')
+	{
+	fputs(inStr + inPos, out);
+	return;
+	}
+    doc2dbsgmlYYrestart(0);
+    BEGIN(state);
+    doc2dbsgmlYYlex();
+}
+
+/* Scans #inStr# as documentation text.
+*/
+static void scanDoc()
+{
+    if(HTMLsyntax)
+	scanText(HTML, htmlSpecial);
+    else
+	scanText(0, texSpecial);
+}
+
 static void printCode(Entry *cur, const char *str)
 {
     inPos = 0;
@@ -795,9 +833,7 @@ static void printCode(Entry *cur, const char *str)
 	printYYDOCdbsgml(cur, str);
 	return;
 	}
-    doc2dbsgmlYYrestart(0);
-    BEGIN(Code);
-    doc2dbsgmlYYlex();
+    scanText(Code, codeSpecial);
 }
 
 static void printCode(Entry *cur, const McString& str)
@@ -814,9 +850,7 @@ void printYYDOCdbsgml(Entry *cur, const char *str, int escapePrcnt)
 	current = cur;
 	escapePercent = escapePrcnt;
 
-	doc2dbsgmlYYrestart(0);
-	BEGIN(HTMLsyntax ? HTML : 0);
-	doc2dbsgmlYYlex();
+	scanDoc();
 	}
 
     escapePercent = 0;
@@ -906,15 +940,15 @@ static int baseDepth(Entry *entry, int n = 1)
     int i, j, nn;
     nn = n + 1;
 
-    for(i = 0 ; i < entry->pubBaseclasses.size(); ++i)
+    for(i = 0 ; i < entry->constExtra().pubBaseclasses.size(); ++i)
 	{
-	j = baseDepth(entry->pubBaseclasses[i], n + 1);
+	j = baseDepth(entry->constExtra().pubBaseclasses[i], n + 1);
 	if(j > nn)
 	    nn = j;
 	}
-    for(i = 0 ; i < entry->proBaseclasses.size(); ++i)
+    for(i = 0 ; i < entry->constExtra().proBaseclasses.size(); ++i)
 	{
-	j = baseDepth(entry->proBaseclasses[i], n + 1);
+	j = baseDepth(entry->constExtra().proBaseclasses[i], n + 1);
 	if(j > nn)
 	    nn = j;
 	}
@@ -932,7 +966,7 @@ static void printYYGraph(const McString& str)
     doc2dbsgmlYYlex();
 }
 
-static void dumpInheritanceEntry(ClassGraph *cls)
+static void dumpInheritanceEntry(const ClassGraph *cls)
 {
     int i;
 
@@ -961,16 +995,14 @@ static void dumpInheritanceEntry(ClassGraph *cls)
 static void dumpHierarchy(Entry *entry)
 {
     int i;
-    ClassGraph *cls;
-    ClassGraph cg(entry, 0);
-    cg.addBases();
-    cg.addDirectChilds();
+    const ClassGraphLayout& cg = ClassGraphLayout::of(entry, false);
+    const ClassGraph *cls = &cg[cg.self()];
 
     fprintf(out, "\\begin{cxxInheritance}\n");
     fprintf(out, "\\paragraph{Inheritance}\\strut\\smallskip\\strut\\\\\n");
 
-    for(cls = cg.firstLine; cls != &cg; cls = cls->nextLine)
-	dumpInheritanceEntry(cls);
+    for(i = 0; i < cg.self(); ++i)
+	dumpInheritanceEntry(&cg[i]);
 
     fprintf(out, "\\cxxInheritanceEntry[x]{");
     for(i = 0; i < cls->indent; ++i)
@@ -989,44 +1021,34 @@ static void dumpHierarchy(Entry *entry)
     fprintf(out, "}{");
     fprintf(out, "}\n");
 
-    for(cls = cls->nextLine; cls; cls = cls->nextLine)
-	dumpInheritanceEntry(cls);
+    for(i = cg.self() + 1; i < cg.size(); ++i)
+	dumpInheritanceEntry(&cg[i]);
 
     fprintf(out, "\\end{cxxInheritance}\n");
 }
 
 static char *checkStr(const char *str)
 {
-    char *new_str = (char *)malloc(strlen(str) + 1);
-    char *return_str = new_str;
-    bool sep_flag = false;
-
-    strcpy(new_str, str);
-
-    while(*new_str != '\0')
-	if(*new_str == '\n')
-	    strcpy(new_str, new_str + 1);
-	else
-	    {
-	    if(*new_str == ' ')
-		sep_flag = true;
-
-	    new_str++;
-	    }
-
-    new_str = return_str;
-
-    if(!sep_flag)
+    static const McScanSet newline("\n");
+    char *return_str = (char *)malloc(strlen(str) + 3);
+    char *new_str = return_str;
+    bool sep_flag = strchr(str, ' ') != 0;
+    const char *end;
+
+    // the lines without their newlines
+    for(;; str = end + 1)
 	{
-	return_str = (char *)malloc(strlen(new_str) + 2);
-	strcpy(return_str, new_str);
-	strcat(return_str, " ");
-	strcpy(new_str, return_str);
+	end = mcScan(str, newline);
+	memcpy(new_str, str, end - str);
+	new_str += end - str;
+	if(*end == '\0')
+	    break;
 	}
 
-    return_str = (char *)malloc(strlen(new_str) + 2);
-    strcpy(return_str, new_str);
-    strcat(return_str, "\n");
+    if(!sep_flag)
+	*new_str++ = ' ';
+    *new_str++ = '\n';
+    *new_str = '\0';
 
     return return_str;
 }
@@ -1111,36 +1133,33 @@ static void dumpJavaDoc(Entry *entry, int *fields, McDArray<McString *> list,
 
 static int dumpFields(Entry *entry)
 {
+    const EntryExtra& x = entry->constExtra();
     int	fields = 0;
 
-    dumpJavaDoc(entry, &fields, entry->exception, "Exceptions");
-    dumpJavaDoc(entry, &fields, entry->precondition, "Preconditions");
-    dumpJavaDoc(entry, &fields, entry->postcondition, "Postconditions");
-    dumpJavaDoc(entry, &fields, entry->invariant, "Invariants");
-    dumpParameter(entry, &fields, entry->param, "Parameter");
+    dumpJavaDoc(entry, &fields, x.exception, "Exceptions");
+    dumpJavaDoc(entry, &fields, x.precondition, "Preconditions");
+    dumpJavaDoc(entry, &fields, x.postcondition, "Postconditions");
+    dumpJavaDoc(entry, &fields, x.invariant, "Invariants");
+    dumpParameter(entry, &fields, x.param, "Parameter");
 
-    if(entry->author.length())
+    if(x.author.length())
 	{
 	fprintf(out, "<author>\n");
 	inPos = 0;
-	inStr = entry->author.c_str();
+	inStr = x.author.c_str();
 	current = entry;
-	doc2dbsgmlYYrestart(0);
-	BEGIN(HTMLsyntax ? HTML : 0);
-	doc2dbsgmlYYlex();
+	scanDoc();
 	fprintf(out, "</author>\n");
 	fields++;
 	}
 
-    if(entry->version.length())
+    if(x.version.length())
 	{
 	fprintf(out, "<releaseinfo>\n");
 	inPos = 0;
-	inStr = entry->version.c_str();
+	inStr = x.version.c_str();
 	current = entry;
-	doc2dbsgmlYYrestart(0);
-	BEGIN(HTMLsyntax ? HTML : 0);
-	doc2dbsgmlYYlex();
+	scanDoc();
 	fprintf(out, "</releaseinfo>\n");
 	fields++;
 	}
@@ -1150,25 +1169,27 @@ static int dumpFields(Entry *entry)
 
 static void strlatex(char *s1, const char *s2)
 {
-    for(;; ++s2)
+    static const McScanSet underscore("_");
+    const char *end;
+
+    for(;; s2 = end + 1)
 	{
-	if((*s2) == '\0')
-	    {
-	    *s1 = *s2;
+	end = mcScan(s2, underscore);
+	memcpy(s1, s2, end - s2);
+	s1 += end - s2;
+	if(*end == '\0')
 	    break;
-	    }
-	if((*s2) == '_')
-	    {
-	    *s1 = '\\';
-	    ++s1;
-	    }
-	*s1 = *s2;++s1;
+	*s1++ = '\\';
+	*s1++ = '_';
 	}
+    *s1 = '\0';
 }
 
 static void dumpEntry(Entry *entry)
 {
+    const EntryExtra& x = entry->constExtra();
     Entry *tmp;
+    const McDArray<Entry*>& subs = entry->subEntries;
     Entry *stack[20];
     int	fields,i;
     int	stack_cnt = 0;
@@ -1287,49 +1308,49 @@ static void dumpEntry(Entry *entry)
 
     fields = dumpFields(entry);
 
-    if(HAS_BASES(entry) || entry->pubChilds.size() || entry->proChilds.size())
+    if(HAS_BASES(entry) || x.pubChilds.size() || x.proChilds.size())
 	dumpHierarchy(entry);
 
-    if(entry->sub)
+    if(subs.size())
 	if((entry->section & INTERFACE_SEC) || (entry->section & CLASS_SEC))
 	    {
-	    for(tmp = entry->sub; tmp; tmp = tmp->next)
-		if(tmp->protection == PUBL)
+	    for(i = 0; i < subs.size(); i++)
+		if(subs[i]->protection == PUBL)
 		    {
 		    fprintf(out, "\\begin{cxxpublic}\n");
-		    for(tmp = entry->sub; tmp; tmp = tmp->next)
-			if(tmp->protection == PUBL)
+		    for(i = 0; i < subs.size(); i++)
+			if(subs[i]->protection == PUBL)
 			    {
 			    fprintf(out, "\\cxxitem");
-			    dumpCxxItem(tmp);
+			    dumpCxxItem(subs[i]);
 			    }
 		    fprintf(out, "\\end{cxxpublic}\n");
 		    break;
 		    }
-	    for(tmp = entry->sub; tmp; tmp = tmp->next)
-		if(tmp->protection == PROT)
+	    for(i = 0; i < subs.size(); i++)
+		if(subs[i]->protection == PROT)
 		    {
 		    fprintf(out, "\\begin{cxxprotected}\n");
-		    for(tmp = entry->sub; tmp; tmp = tmp->next)
-			if(tmp->protection == PROT)
+		    for(i = 0; i < subs.size(); i++)
+			if(subs[i]->protection == PROT)
 			    {
 			    fprintf(out, "\\cxxitem");
-			    dumpCxxItem(tmp);
+			    dumpCxxItem(subs[i]);
 			    }
 		    fprintf(out, "\\end{cxxprotected}\n");
 		    break;
 		    }
 	    if(withPrivate)
 		{
-		for(tmp = entry->sub; tmp; tmp = tmp->next)
-		    if(tmp->protection == PRIV)
+		for(i = 0; i < subs.size(); i++)
+		    if(subs[i]->protection == PRIV)
 			{
 			fprintf(out, "\\begin{cxxprivate}\n");
-			for(tmp = entry->sub; tmp; tmp = tmp->next)
-			    if(tmp->protection == PRIV)
+			for(i = 0; i < subs.size(); i++)
+			    if(subs[i]->protection == PRIV)
 				{
 				fprintf(out, "\\cxxitem");
-				dumpCxxItem(tmp);
+				dumpCxxItem(subs[i]);
 				}
 			fprintf(out, "\\end{cxxprivate}\n");
 			break;
@@ -1340,10 +1361,10 @@ static void dumpEntry(Entry *entry)
 	    {
 	    fprintf(out, "\\begin{cxxnames}\n");
 
-	    for(tmp = entry->sub; tmp; tmp = tmp->next)
+	    for(i = 0; i < subs.size(); i++)
 		{
 		fprintf(out, "\\cxxitem");
-		dumpCxxItem(tmp);
+		dumpCxxItem(subs[i]);
 		}
 	    fprintf(out, "\\end{cxxnames}\n");
 	    }
@@ -1355,30 +1376,30 @@ static void dumpEntry(Entry *entry)
 	fprintf(out, "</para></refsect1>\n");
 	}
 
-    dumpReturn(entry, &fields, entry->retrn, "Return");
+    dumpReturn(entry, &fields, x.retrn, "Return");
 
-    for(tmp = entry->sub; tmp; tmp = tmp->next)
-	if(tmp->protection == PUBL && MAKE_DOC(tmp))
-	    dumpEntry(tmp);
+    for(i = 0; i < subs.size(); i++)
+	if(subs[i]->protection == PUBL && MAKE_DOC(subs[i]))
+	    dumpEntry(subs[i]);
 
-    for(tmp = entry->sub; tmp; tmp = tmp->next)
-	if(tmp->protection == PROT && MAKE_DOC(tmp))
-	    dumpEntry(tmp);
+    for(i = 0; i < subs.size(); i++)
+	if(subs[i]->protection == PROT && MAKE_DOC(subs[i]))
+	    dumpEntry(subs[i]);
 
     if(withPrivate)
-	for(tmp = entry->sub; tmp; tmp = tmp->next)
-	    if(tmp->protection == PRIV && MAKE_DOC(tmp))
-		dumpEntry(tmp);
+	for(i = 0; i < subs.size(); i++)
+	    if(subs[i]->protection == PRIV && MAKE_DOC(subs[i]))
+		dumpEntry(subs[i]);
 
-    if(entry->see.size())
+    if(x.see.size())
 	{
 	fprintf(out, "<refsect1><title>See Also</title>\n<para>\n");
 	char *p;
-	for(i = 0; i < entry->see.size(); ++i)
+	for(i = 0; i < x.see.size(); ++i)
 	    {
 	    if(i)
 		fprintf(out,", ");
-	    p = strdup(entry->see[i]->c_str());
+	    p = strdup(x.see[i]->c_str());
 	    if(p[strlen(p) - 1] == '\n')
 		p[strlen(p) - 1] = '\0';
 	    fprintf(out, "<link linkend=number");
@@ -1429,9 +1450,14 @@ static int atMostDepth(Entry *tmp, int depth)
 	return !tmp;
 }
 
-static bool relevantContents(Entry *tmp)
+static bool relevantContents(Entry *entry)
 {
-    for(tmp = tmp->sub; tmp; tmp = tmp->next)
+    Entry *tmp;
+    int i;
+
+    for(i = 0; i < entry->subEntries.size(); i++)
+	{
+	tmp = entry->subEntries[i];
 	if(MAKE_DOC(tmp) && (atMostDepth(tmp, depthTOC + 1) ||
 	    (tmp->section & CLASS_SEC) ||
 	    tmp->section == UNION_SEC ||
@@ -1440,12 +1466,18 @@ static bool relevantContents(Entry *tmp)
 	    tmp->section == PACKAGE_SEC ||
 	    tmp->section == NAMESPACE_SEC))
 	    return true;
+	}
     return false;
 }
 
-static void dumpContents(Entry *tmp)
+static void dumpContents(Entry *entry)
 {
-    for(tmp = tmp->sub; tmp; tmp = tmp->next)
+    Entry *tmp;
+    int i;
+
+    for(i = 0; i < entry->subEntries.size(); i++)
+	{
+	tmp = entry->subEntries[i];
 	if(MAKE_DOC(tmp) && (atMostDepth(tmp, depthTOC + 1) ||
 	    (tmp->section & CLASS_SEC) ||
 	    tmp->section == UNION_SEC ||
@@ -1461,21 +1493,20 @@ static void dumpContents(Entry *tmp)
 	    fprintf(out, "}{");
 	    printYYDOCdbsgml(tmp, tmp->memo.c_str());
 	    fprintf(out, "}\n");
-	    if(tmp->sub && relevantContents(tmp))
+	    if(tmp->subEntries.size() && relevantContents(tmp))
 		{
 		fprintf(out, "\\begin{cxxContents}\n");
 		dumpContents(tmp);
 		fprintf(out, "\\end{cxxContents}\n");
 		}
 	    }
+	}
 }
 
 static void dumpClassGraph(Entry *entry)
 {
-    ClassGraph cg(entry, 0);
-    ClassGraph *cls = &cg;
-    cg.addBases();
-    cg.addAllChilds();
+    const ClassGraphLayout& cg = ClassGraphLayout::of(entry, true);
+    const ClassGraph *cls = &cg[cg.self()];
 
     fprintf(out, "\\strut\\\\[5pt]\\goodbreak\n");
 
@@ -1495,8 +1526,10 @@ static void dumpClassGraph(Entry *entry)
     fprintf(out, "}{");
     fprintf(out, "}\n");
 
-    for(cls = cls->nextLine; cls; cls = cls->nextLine)
+    for(int line = cg.self() + 1; line < cg.size(); ++line)
 	{
+	cls = &cg[line];
+
 	if((cls->entry->fromUnknownPackage) || (onlyClassGraph))
 	    fprintf(out, "\\cxxClassGraphEntryUnknownPackage{");
 	else
@@ -1525,28 +1558,29 @@ static void dumpClassGraph(Entry *entry)
 
 static void dumpClassGraphs(Entry *tmp)
 {
-    for(; tmp; tmp = tmp->next)
+    int i;
+
+    if((tmp->section & CLASS_SEC) &&
+	tmp->constExtra().proBaseclasses.size() == 0 &&
+	tmp->constExtra().pubBaseclasses.size() == 0)
 	{
-	if((tmp->section & CLASS_SEC) &&
-	    tmp->proBaseclasses.size() == 0 &&
-	    tmp->pubBaseclasses.size() == 0)
-	    {
-	    tmp->currentParent = 0;
-	    dumpClassGraph(tmp);
-	    }
-	dumpClassGraphs(tmp->sub);
+	tmp->currentParent = 0;
+	dumpClassGraph(tmp);
 	}
+    for(i = 0; i < tmp->subEntries.size(); i++)
+	dumpClassGraphs(tmp->subEntries[i]);
 }
 
 void usermanDBsgml(char *str, Entry *root)
 {
-    Entry *tmp;
+    int i;
 
     initDocbook();
 
-    if(root->sub && root->sub->next == 0 && root->sub->section == MANUAL_SEC)
+    if(root->subEntries.size() == 1 &&
+	root->subEntries[0]->section == MANUAL_SEC)
 	{
-	root = root->sub;
+	root = root->subEntries[0];
 	root->parent = 0;
 	}
 
@@ -1577,8 +1611,8 @@ void usermanDBsgml(char *str, Entry *root)
 		}
     	    }
 
-    	for(tmp = root->sub; tmp; tmp = tmp->next)
-	    dumpEntry(tmp);
+    	for(i = 0; i < root->subEntries.size(); i++)
+	    dumpEntry(root->subEntries[i]);
 	}
 
     if(!noClassGraph && relevantClassGraphs(root))
@@ -26,10 +26,16 @@
 #include <string.h>
 #include <time.h>
 
+#include "McAlloc.h"
+#include "McScan.h"
 #include "doc.h"
 #include "nametable.h"
+#include "stats.h"
+#include "tex2mathml.h"
+#include "yyread.h"
 
 extern NameTable	gifs;
+extern NameTableFile	gifsFile;
 
 #define YY_DECL int yylex()
 
@@ -46,6 +52,8 @@ static void push(char *);
 static char *pop();
 static void Output(const char *);
 static void Output(const McString& o);
+static void outputWord(const char *word);
+static void outputText(const char *text);
 static char *tabFlag = 0;
 static int doItem = 0;
 static bool yyWithLinks = false;
@@ -55,14 +63,7 @@ static Entry *context;
 
 static int yyread(char *buf, int max_size)
 {
-    int c = 0;
-    while(c < max_size && inputPosition < inLen)
-	{
-	*buf = inStr[inputPosition++];
-	c++;
-	buf++;
-	}
-    return c;
+    return yyReadString(buf, max_size, inStr, inputPosition);
 }
 
 static void outputTeX(const char *text)
@@ -73,19 +74,33 @@ static void outputTeX(const char *text)
 	/* if the command starts with hspace it can not be visualized in a gif*/
 	return;
 
+    if(useMathML)
+	{
+	McString mathml;
+	if(texToMathML(text, mathml))
+	    {
+	    Output(mathml);
+	    return;
+	    }
+	}
+
     if(noGifs)
 	{
 	Output("<PRE>");
 	Output(text);
 	Output("</PRE>");
 	}
-    if(!gifs.has(text))
+    if(!(num = gifsFile.find(text)))
 	{
-	gifs.add(gifs.num() + 1, text);
-	num = gifs.num();
+	if(!gifs.has(text))
+	    {
+	    // new formulas are numbered after the ones of the GIF database
+	    num = gifsFile.maxNumber() + gifs.num() + 1;
+	    gifs.add(num, text);
+	    }
+	else
+	    num = gifs[text];
 	}
-    else
-	num = gifs[text];
 
     char buf[200];
     sprintf(buf, "<IMG BORDER=0 SRC=g%06d.gif>", num);
@@ -786,21 +801,16 @@ arg      [^\n}\]]*
 			tabFlag--;
 			}
 
+<DXXisTeX>[^\\{}\]$#&<>\n]+	{
+			outputText(yytext);
+			}
+
+<DXXisHTML>[^\\{\n]+	{
+			outputText(yytext);
+			}
+
 <DXXisCode,DXXisTeX,DXXisHTML,JAVA_SEE>[a-z_A-Z0-9:.]*	{
-			if(yyWithLinks)
-			    {
-                            Entry *ref = getRefEntry(yytext, context);
-			    if(ref)
-				{
-				McString tmp;
-				entry2link(tmp, ref, (const char *)yytext);
-				Output(tmp);			
-		    		}
-			    else
-				Output(yytext);
-                    	    }
-			else
-			    Output(yytext);
+			outputWord(yytext);
     			}
 
 <JAVA_SEE>[A-Za-z_.0-9]*"#"[A-Za-z_.0-9]*	{
@@ -877,8 +887,65 @@ static void Output(const McString& o)
     outStr += o;
 }
 
+// writes #word#, as a link if it names an entry and links are wanted
+static void outputWord(const char *word)
+{
+    if(yyWithLinks)
+	{
+	Entry *ref = getRefEntry(word, context);
+	if(ref)
+	    {
+	    McString tmp;
+	    entry2link(tmp, ref, word);
+	    Output(tmp);
+	    return;
+	    }
+	}
+    Output(word);
+}
+
+static inline bool isWordChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+	(c >= '0' && c <= '9') || c == '_' || c == ':' || c == '.';
+}
+
+/* Writes a run of text that no rule but the one for words acts upon. With
+   links the words are looked up one by one, as that rule would.
+*/
+static void outputText(const char *text)
+{
+    const char *end;
+
+    if(!yyWithLinks)
+	{
+	Output(text);
+	return;
+	}
+    while(*text)
+	{
+	for(end = text; isWordChar(*end); end++)
+	    ;
+	if(end > text)
+	    outputWord(McString(text, 0, end - text).c_str());
+	else
+	    {
+	    while(*end && !isWordChar(*end))
+		end++;
+	    Output(McString(text, 0, end - text));
+	    }
+	text = end;
+	}
+}
+
 // This is really called lots, so add a quick exit if nothing to do!
 static char blank[] = "";
+
+// Characters the rules of DXXisTeX and DXXisHTML act upon, other than
+// those of words. Without links, a string without them is copied as it is.
+static const McScanSet texSpecial("\\{}]$#&<>\n");
+static const McScanSet htmlSpecial("\\{\n");
+
 char *strToHtml(McString &in, char *dest, Entry* ct, bool withLinks, bool pureCode)
 {
     if(in.length() == 0) // This really does save time.
@@ -905,14 +972,29 @@ char *strToHtml(McString &in, char *dest, Entry* ct, bool withLinks, bool pureCo
 	else
 	    initial = DXXisTeX;
     BEGIN(initial);
-    doc2htmlYYlex();
+
+    if(!withLinks && !pureCode &&
+	*mcScan(inStr, HTMLsyntax ? htmlSpecial : texSpecial) == '\0')
+	outStr = in;
+    else
+	doc2htmlYYlex();
+
+    docStats.htmlConversions++;
+    docStats.htmlBytes += outStr.length();
     if(dest)
 	{
 	strcpy(dest, outStr.c_str());
 	return dest;
 	}
     else 
-	return strdup(outStr.c_str());
+	return mcStrdup(outStr.c_str(), MC_TAG_HTML);
+}
+
+// Frees a string returned by strToHtml() or seeToHtml()
+void freeHtml(char *html)
+{
+    if(html && html != blank)
+	mcFree(html, strlen(html) + 1, MC_TAG_HTML);
 }
 
 char *seeToHtml(McString &in, Entry *ct)
@@ -928,5 +1010,7 @@ char *seeToHtml(McString &in, Entry *ct)
     yyWithLinks = true;
     BEGIN(JAVA_SEE);
     doc2htmlYYlex();
-    return strdup(outStr.c_str());
+    docStats.htmlConversions++;
+    docStats.htmlBytes += outStr.length();
+    return mcStrdup(outStr.c_str(), MC_TAG_HTML);
 }
@@ -31,7 +31,9 @@
 #include <time.h>
 
 #include "classgraph.h"
+#include "McScan.h"
 #include "doc.h"
+#include "yyread.h"
 
 #define YY_DECL int yylex()
 
@@ -65,14 +67,7 @@ static int	tabFlag		= 0;
 
 static int yyread(char *buf, int max_size)
 {
-    int c = 0;
-    while(c < max_size && inStr[inPos])
-	{
-	*buf = inStr[inPos++];
-	c++;
-	buf++;
-	}
-    return c;
+    return yyReadString(buf, max_size, inStr, inPos);
 }
 
 extern "C" {
@@ -376,6 +371,10 @@ static void closeVerbMode()
 			fprintf(out, "$\\hat{\\;}$");
 			}
 
+<Code>[^#$%&<>\\^_{} ~\x06]+	{
+			fwrite(yytext, 1, yyleng, out);
+			}
+
 <HTMLlist,TeXlist,Ref,LVerb,Verb,Code>(.|\n)	{
 			fprintf(out, "%c", *yytext);
 			}
@@ -461,6 +460,10 @@ static void closeVerbMode()
 			BEGIN(0);
 			}
 
+[^#$%&<>\\_{~\x06]+	{
+			fwrite(yytext, 1, yyleng, out);
+			}
+
 .			{
 			fprintf(out, "%s", yytext);
 			}
@@ -623,6 +626,10 @@ static void closeVerbMode()
 			fprintf(out, "$\\backslash$");
 			}
 
+<HTML>[^#$%&<>\\_{}\x06]+	{
+			fwrite(yytext, 1, yyleng, out);
+			}
+
 <HTML>.			{
 			fprintf(out, "%s", yytext);
 			}
@@ -1032,6 +1039,37 @@ void listing(char *str)
     finitLatex();
 }
 
+// Characters the rules of Code, INITIAL and HTML act upon, the rules
+// copy the runs of all others as they are
+static const McScanSet codeSpecial("#$%&<>\\^_{} ~\006");
+static const McScanSet texSpecial("#$%&<>\\_{~\006");
+static const McScanSet htmlSpecial("#$%&<>\\_{}\006");
+
+/* Scans #inStr# from #inPos# on in start condition #state#. Text without
+   any character in #special# is written as it is.
+*/
+static void scanText(int state, const McScanSet& special)
+{
+    if(*mcScan(inStr + inPos, special) == '\0')
+	{
+	fputs(inStr + inPos, out);
+	return;
+	}
+    doc2texYYrestart(0);
+    BEGIN(state);
+    doc2texYYlex();
+}
+
+/* Scans #inStr# as documentation text.
+*/
+static void scanDoc()
+{
+    if(HTMLsyntax)
+	scanText(HTML, htmlSpecial);
+    else
+	scanText(0, texSpecial);
+}
+
 static void printCode(Entry *cur, const char *str)
 {
     inPos = 0;
@@ -1042,9 +1080,7 @@ static void printCode(Entry *cur, const char *str)
 	printYYDOC(cur, str);
 	return;
 	}
-    doc2texYYrestart(0);
-    BEGIN(Code);
-    doc2texYYlex();
+    scanText(Code, codeSpecial);
 }
 
 static void printCode(Entry *cur, const McString& str)
@@ -1061,9 +1097,7 @@ void printYYDOC(Entry *cur, const char *str, int escapePrcnt)
 	current = cur;
 	escapePercent = escapePrcnt;
 
-	doc2texYYrestart(0);
-	BEGIN(HTMLsyntax ? HTML : 0);
-	doc2texYYlex();
+	scanDoc();
 	}
 
     escapePercent = 0;
@@ -1127,15 +1161,15 @@ static int baseDepth(Entry *entry, int n = 1)
     int i, j, nn;
     nn = n + 1;
 
-    for(i = 0 ; i < entry->pubBaseclasses.size(); ++i)
+    for(i = 0 ; i < entry->constExtra().pubBaseclasses.size(); ++i)
 	{
-	j = baseDepth(entry->pubBaseclasses[i], n + 1);
+	j = baseDepth(entry->constExtra().pubBaseclasses[i], n + 1);
 	if(j > nn)
 	    nn = j;
 	}
-    for(i = 0 ; i < entry->proBaseclasses.size(); ++i)
+    for(i = 0 ; i < entry->constExtra().proBaseclasses.size(); ++i)
 	{
-	j = baseDepth(entry->proBaseclasses[i], n + 1);
+	j = baseDepth(entry->constExtra().proBaseclasses[i], n + 1);
 	if(j > nn)
 	    nn = j;
 	}
@@ -1153,7 +1187,7 @@ void printYYGraph(const McString& str)
     doc2texYYlex();
 }
 
-static void dumpInheritanceEntry(ClassGraph *cls)
+static void dumpInheritanceEntry(const ClassGraph *cls)
 {
     int i;
 
@@ -1182,16 +1216,14 @@ static void dumpInheritanceEntry(ClassGraph *cls)
 static void dumpHierarchy(Entry *entry)
 {
     int i;
-    ClassGraph *cls;
-    ClassGraph cg(entry, 0);
-    cg.addBases();
-    cg.addDirectChilds();
+    const ClassGraphLayout& cg = ClassGraphLayout::of(entry, false);
+    const ClassGraph *cls = &cg[cg.self()];
 
     fprintf(out, "\\begin{cxxInheritance}\n");
     fprintf(out, "\\paragraph{Inheritance}\\strut\\smallskip\\strut\\\\\n");
 
-    for(cls = cg.firstLine; cls != &cg; cls = cls->nextLine)
-	dumpInheritanceEntry(cls);
+    for(i = 0; i < cg.self(); ++i)
+	dumpInheritanceEntry(&cg[i]);
 
     fprintf(out, "\\cxxInheritanceEntry[x]{");
     for(i = 0; i < cls->indent; ++i)
@@ -1210,44 +1242,34 @@ static void dumpHierarchy(Entry *entry)
     fprintf(out, "}{");
     fprintf(out, "}\n");
 
-    for(cls = cls->nextLine; cls; cls = cls->nextLine)
-	dumpInheritanceEntry(cls);
+    for(i = cg.self() + 1; i < cg.size(); ++i)
+	dumpInheritanceEntry(&cg[i]);
 
     fprintf(out, "\\end{cxxInheritance}\n");
 }
 
 static char *checkStr(const char *str)
 {
-    char *new_str = (char *)malloc(strlen(str) + 1);
-    char *return_str = new_str;
-    bool sep_flag = false;
-
-    strcpy(new_str, str);
-
-    while(*new_str != '\0')
-	if(*new_str == '\n')
-	    strcpy(new_str, new_str + 1);
-	else
-	    {
-	    if(*new_str == ' ')
-		sep_flag = true;
-
-	    new_str++;
-	    }
-
-    new_str = return_str;
-
-    if(!sep_flag)
+    static const McScanSet newline("\n");
+    char *return_str = (char *)malloc(strlen(str) + 3);
+    char *new_str = return_str;
+    bool sep_flag = strchr(str, ' ') != 0;
+    const char *end;
+
+    // the lines without their newlines
+    for(;; str = end + 1)
 	{
-	return_str = (char *)malloc(strlen(new_str) + 2);
-	strcpy(return_str, new_str);
-	strcat(return_str, " ");
-	strcpy(new_str, return_str);
+	end = mcScan(str, newline);
+	memcpy(new_str, str, end - str);
+	new_str += end - str;
+	if(*end == '\0')
+	    break;
 	}
 
-    return_str = (char *)malloc(strlen(new_str) + 2);
-    strcpy(return_str, new_str);
-    strcat(return_str, "\n");
+    if(!sep_flag)
+	*new_str++ = ' ';
+    *new_str++ = '\n';
+    *new_str = '\0';
 
     return return_str;
 }
@@ -1287,9 +1309,7 @@ static void dumpTeXField(Entry *entry, int *fields, McString text, char *descrip
 	inPos = 0;
 	inStr = text.c_str();
 	current = entry;
-	doc2texYYrestart(0);
-	BEGIN(HTMLsyntax ? HTML : 0);
-	doc2texYYlex();
+	scanDoc();
 	fprintf(out, "\\strut}\n");
 	(*fields)++;
 	}
@@ -1297,36 +1317,37 @@ static void dumpTeXField(Entry *entry, int *fields, McString text, char *descrip
 
 static int dumpFields(Entry *entry)
 {
+    const EntryExtra& x = entry->constExtra();
     int	i, fields = 0;
 
-    dumpTeXList(entry, &fields, entry->invariant, "Invariants");
-    dumpTeXList(entry, &fields, entry->exception, "Exceptions");
-    dumpTeXList(entry, &fields, entry->param, "Parameter");
-    dumpTeXList(entry, &fields, entry->retrn, "Return");
-    dumpTeXList(entry, &fields, entry->precondition, "Preconditions");
-    dumpTeXList(entry, &fields, entry->postcondition, "Postconditions");
+    dumpTeXList(entry, &fields, x.invariant, "Invariants");
+    dumpTeXList(entry, &fields, x.exception, "Exceptions");
+    dumpTeXList(entry, &fields, x.param, "Parameter");
+    dumpTeXList(entry, &fields, x.retrn, "Return");
+    dumpTeXList(entry, &fields, x.precondition, "Preconditions");
+    dumpTeXList(entry, &fields, x.postcondition, "Postconditions");
 
-    dumpTeXField(entry, &fields, entry->author, "Author");
-    dumpTeXField(entry, &fields, entry->version, "Version");
-    dumpTeXField(entry, &fields, entry->deprecated, "Deprecated");
-    dumpTeXField(entry, &fields, entry->since, "Since");
+    dumpTeXField(entry, &fields, x.author, "Author");
+    dumpTeXField(entry, &fields, x.version, "Version");
+    dumpTeXField(entry, &fields, x.deprecated, "Deprecated");
+    dumpTeXField(entry, &fields, x.since, "Since");
 
-    if(entry->see.size())
+    if(x.see.size())
 	{
 	fprintf(out, "\\cxxSee{");
-	for(i = 0; i < entry->see.size(); ++i)
+	for(i = 0; i < x.see.size(); ++i)
 	    {
 	    if(i)
 		fprintf(out, "\\\\\n");
 	    if(HTMLsyntax)
 		fprintf(out, "{\\tt\\strut ");
 	    inPos = 0;
-	    inStr = entry->see[i]->c_str();
+	    inStr = x.see[i]->c_str();
 	    current = entry;
 	    doc2texYYrestart(0);
 	    BEGIN(HTMLsyntax ? HTMLlist : Code);
 	    doc2texYYlex();
-	    Entry *ref = getRefEntry(*entry->see[i], current);
+	    Entry *ref = getRefEntry(*x.see[i], current);
 	    if(ref)
 		{
 		fprintf(out, " ($\\rightarrow$");
@@ -1349,27 +1370,28 @@ static int dumpFields(Entry *entry)
 
 static void strlatex(char *s1, const char *s2)
 {
-    for(;; ++s2)
+    static const McScanSet underscore("_");
+    const char *end;
+
+    for(;; s2 = end + 1)
 	{
-	if((*s2) == '\0')
-	    {
-	    *s1 = *s2;
+	end = mcScan(s2, underscore);
+	memcpy(s1, s2, end - s2);
+	s1 += end - s2;
+	if(*end == '\0')
 	    break;
-	    }
-	if((*s2) == '_')
-	    {
-	    *s1 = '\\';
-	    ++s1;
-	    }
-	*s1 = *s2;++s1;
+	*s1++ = '\\';
+	*s1++ = '_';
 	}
+    *s1 = '\0';
 }
 
 void dumpEntry(Entry *entry)
 {
     Entry *tmp;
+    const McDArray<Entry*>& subs = entry->subEntries;
     Entry *stack[20];
-    int	fields;
+    int	fields, i;
     int	stack_cnt = 0;
     char *sectionType = 0;
 
@@ -1486,49 +1508,49 @@ void dumpEntry(Entry *entry)
 
     fields = dumpFields(entry);
 
-    if(HAS_BASES(entry) || entry->pubChilds.size() || entry->proChilds.size())
+    if(HAS_BASES(entry) || entry->constExtra().pubChilds.size() || entry->constExtra().proChilds.size())
 	dumpHierarchy(entry);
 
-    if(entry->sub)
+    if(subs.size())
 	if((entry->section & INTERFACE_SEC) || (entry->section & CLASS_SEC))
 	    {
-	    for(tmp = entry->sub; tmp; tmp = tmp->next)
-		if(tmp->protection == PUBL)
+	    for(i = 0; i < subs.size(); i++)
+		if(subs[i]->protection == PUBL)
 		    {
 		    fprintf(out, "\\begin{cxxpublic}\n");
-		    for(tmp = entry->sub; tmp; tmp = tmp->next)
-			if(tmp->protection == PUBL)
+		    for(i = 0; i < subs.size(); i++)
+			if(subs[i]->protection == PUBL)
 			    {
 			    fprintf(out, "\\cxxitem");
-			    dumpCxxItem(tmp);
+			    dumpCxxItem(subs[i]);
 			    }
 		    fprintf(out, "\\end{cxxpublic}\n");
 		    break;
 		    }
-	    for(tmp = entry->sub; tmp; tmp = tmp->next)
-		if(tmp->protection == PROT)
+	    for(i = 0; i < subs.size(); i++)
+		if(subs[i]->protection == PROT)
 		    {
 		    fprintf(out, "\\begin{cxxprotected}\n");
-		    for(tmp = entry->sub; tmp; tmp = tmp->next)
-			if(tmp->protection == PROT)
+		    for(i = 0; i < subs.size(); i++)
+			if(subs[i]->protection == PROT)
 			    {
 			    fprintf(out, "\\cxxitem");
-			    dumpCxxItem(tmp);
+			    dumpCxxItem(subs[i]);
 			    }
 		    fprintf(out, "\\end{cxxprotected}\n");
 		    break;
 		    }
 	    if(withPrivate)
 		{
-		for(tmp = entry->sub; tmp; tmp = tmp->next)
-		    if(tmp->protection == PRIV)
+		for(i = 0; i < subs.size(); i++)
+		    if(subs[i]->protection == PRIV)
 			{
 			fprintf(out, "\\begin{cxxprivate}\n");
-			for(tmp = entry->sub; tmp; tmp = tmp->next)
-			    if(tmp->protection == PRIV)
+			for(i = 0; i < subs.size(); i++)
+			    if(subs[i]->protection == PRIV)
 				{
 				fprintf(out, "\\cxxitem");
-				dumpCxxItem(tmp);
+				dumpCxxItem(subs[i]);
 				}
 			fprintf(out, "\\end{cxxprivate}\n");
 			break;
@@ -1540,10 +1562,10 @@ void dumpEntry(Entry *entry)
 		{
 		fprintf(out, "\\begin{cxxnames}\n");
 	    
-		for(tmp = entry->sub; tmp; tmp = tmp->next)
+		for(i = 0; i < subs.size(); i++)
 		    {
 		    fprintf(out, "\\cxxitem");
-		    dumpCxxItem(tmp);
+		    dumpCxxItem(subs[i]);
 		    }
 		fprintf(out, "\\end{cxxnames}\n");
 		}
@@ -1555,18 +1577,18 @@ void dumpEntry(Entry *entry)
 	fprintf(out, "\n\\end{cxxdoc}\n");
 	}
 
-    for(tmp = entry->sub; tmp; tmp = tmp->next)
-	if(tmp->protection == PUBL && MAKE_DOC(tmp))
-	    dumpEntry(tmp);
+    for(i = 0; i < subs.size(); i++)
+	if(subs[i]->protection == PUBL && MAKE_DOC(subs[i]))
+	    dumpEntry(subs[i]);
 
-    for(tmp = entry->sub; tmp; tmp = tmp->next)
-	if(tmp->protection == PROT && MAKE_DOC(tmp))
-	    dumpEntry(tmp);
+    for(i = 0; i < subs.size(); i++)
+	if(subs[i]->protection == PROT && MAKE_DOC(subs[i]))
+	    dumpEntry(subs[i]);
 
     if(withPrivate)
-	for(tmp = entry->sub; tmp; tmp = tmp->next)
-	    if(tmp->protection == PRIV && MAKE_DOC(tmp))
-		dumpEntry(tmp);
+	for(i = 0; i < subs.size(); i++)
+	    if(subs[i]->protection == PRIV && MAKE_DOC(subs[i]))
+		dumpEntry(subs[i]);
 
     switch(entry->section)
 	{
@@ -1605,9 +1627,14 @@ static int atMostDepth(Entry *tmp, int depth)
     return !tmp;
 }
 
-static bool relevantContents(Entry *tmp)
+static bool relevantContents(Entry *entry)
 {
-    for(tmp = tmp->sub; tmp; tmp = tmp->next)
+    Entry *tmp;
+    int i;
+
+    for(i = 0; i < entry->subEntries.size(); i++)
+	{
+	tmp = entry->subEntries[i];
 	if(MAKE_DOC(tmp) && (atMostDepth(tmp, depthTOC + 1) ||
 	    (tmp->section & CLASS_SEC) ||
 	    tmp->section == UNION_SEC ||
@@ -1616,12 +1643,18 @@ static bool relevantContents(Entry *tmp)
 	    tmp->section == PACKAGE_SEC ||
 	    tmp->section == NAMESPACE_SEC))
 	    return true;
+	}
     return false;
 }
 
-static void dumpContents(Entry *tmp)
+static void dumpContents(Entry *entry)
 {
-    for(tmp = tmp->sub; tmp; tmp = tmp->next)
+    Entry *tmp;
+    int i;
+
+    for(i = 0; i < entry->subEntries.size(); i++)
+	{
+	tmp = entry->subEntries[i];
 	if(MAKE_DOC(tmp) && (atMostDepth(tmp, depthTOC + 1) ||
 	    (tmp->section & CLASS_SEC) ||
 	    tmp->section == UNION_SEC ||
@@ -1637,21 +1670,20 @@ static void dumpContents(Entry *tmp)
 	    fprintf(out, "}{");
 	    printYYDOC(tmp, tmp->memo.c_str());
 	    fprintf(out, "}\n");
-	    if(tmp->sub && relevantContents(tmp))
+	    if(tmp->subEntries.size() && relevantContents(tmp))
 		{
 		fprintf(out, "\\begin{cxxContents}\n");
 		dumpContents(tmp);
 		fprintf(out, "\\end{cxxContents}\n");
 		}
 	    }
+	}
 }
 
 static void dumpClassGraph(Entry *entry)
 {
-    ClassGraph cg(entry, 0);
-    ClassGraph *cls = &cg;
-    cg.addBases();
-    cg.addAllChilds();
+    const ClassGraphLayout& cg = ClassGraphLayout::of(entry, true);
+    const ClassGraph *cls = &cg[cg.self()];
 
     fprintf(out, "\\strut\\\\[5pt]\\goodbreak\n");
 
@@ -1671,8 +1703,10 @@ static void dumpClassGraph(Entry *entry)
     fprintf(out, "}{");
     fprintf(out, "}\n");
 
-    for(cls = cls->nextLine; cls; cls = cls->nextLine)
+    for(int line = cg.self() + 1; line < cg.size(); ++line)
 	{
+	cls = &cg[line];
+
 	if((cls->entry->fromUnknownPackage) || (onlyClassGraph))
 	    fprintf(out, "\\cxxClassGraphEntryUnknownPackage{");
 	else
@@ -1701,28 +1735,29 @@ static void dumpClassGraph(Entry *entry)
 
 static void dumpClassGraphs(Entry *tmp)
 {
-    for(; tmp; tmp = tmp->next)
+    int i;
+
+    if((tmp->section & CLASS_SEC) &&
+	tmp->constExtra().proBaseclasses.size() == 0 &&
+	tmp->constExtra().pubBaseclasses.size() == 0)
 	{
-	if((tmp->section & CLASS_SEC) &&
-	    tmp->proBaseclasses.size() == 0 &&
-	    tmp->pubBaseclasses.size() == 0)
-	    {
-	    tmp->currentParent = 0;
-	    dumpClassGraph(tmp);
-	    }
-	dumpClassGraphs(tmp->sub);
+	tmp->currentParent = 0;
+	dumpClassGraph(tmp);
 	}
+    for(i = 0; i < tmp->subEntries.size(); i++)
+	dumpClassGraphs(tmp->subEntries[i]);
 }
 
 void usermanTeX(char *str, Entry *root)
 {
-    Entry *tmp;
+    int i;
 
     initLatex();
 
-    if(root->sub && root->sub->next == 0 && root->sub->section == MANUAL_SEC)
+    if(root->subEntries.size() == 1 &&
+	root->subEntries[0]->section == MANUAL_SEC)
 	{
-	root = root->sub;
+	root = root->subEntries[0];
 	root->parent = 0;
 	}
 
@@ -1753,8 +1788,8 @@ void usermanTeX(char *str, Entry *root)
 		}
     	    }
 
-    	for(tmp = root->sub; tmp; tmp = tmp->next)
-	    dumpEntry(tmp);
+    	for(i = 0; i < root->subEntries.size(); i++)
+	    dumpEntry(root->subEntries[i]);
 	}
 
     if(!noClassGraph && relevantClassGraphs(root))
@@ -22,6 +22,7 @@
 
 %{
 #include "doc.h"
+#include "yyread.h"
 
 #define YY_DECL int yylex()
 
@@ -33,14 +34,7 @@ static const char*	inStr;
 
 static int yyread(char *buf, int max_size)
 {
-    int c = 0;
-    while(c < max_size && inStr[inPos])
-	{
-	*buf = inStr[inPos++];
-	c++;
-	buf++;
-	}
-    return c;
+    return yyReadString(buf, max_size, inStr, inPos);
 }
 
 extern "C" {
@@ -0,0 +1,685 @@
+/*
+  docdb.cc
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this program; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "McDArray.h"
+#include "McHashTable.h"
+#include "McSorter.h"
+#include "doc.h"
+#include "docdb.h"
+
+static const char docDBMagic[8] = { 'D', 'X', 'X', 'D', 'O', 'C', 'D', 'B' };
+static const unsigned int docDBVersion = 1;
+static const unsigned int docDBByteOrder = 0x01020304;
+
+const unsigned int DocDBFile::none;
+
+bool DocDBFile::open(const char *path)
+{
+    close();
+
+    if(!data.open(path))
+	return false;
+
+    const char *base = data.data();
+    unsigned long size = data.size();
+    const Header *h = (const Header *)base;
+
+    if(size < sizeof(Header) || memcmp(h->magic, docDBMagic, 8) != 0 ||
+	h->version != docDBVersion || h->byteOrder != docDBByteOrder ||
+	h->stringsSize == 0 ||
+	// no block may be larger than the file, so that the sum can't wrap
+	h->count > size / (sizeof(Record) + sizeof(unsigned int)) ||
+	h->linksSize > size / sizeof(unsigned int) ||
+	h->tagsSize > size / sizeof(Tag) || h->filesSize > size / sizeof(File) ||
+	h->stringsSize > size ||
+	size != sizeof(Header) + h->count * sizeof(Record) +
+	    h->count * sizeof(unsigned int) +
+	    h->linksSize * sizeof(unsigned int) + h->tagsSize * sizeof(Tag) +
+	    h->filesSize * sizeof(File) + h->stringsSize ||
+	base[size - 1] != 0)
+	{
+	data.close();
+	return false;
+	}
+
+    header = h;
+    records = (const Record *)(base + sizeof(Header));
+    names = (const unsigned int *)(records + h->count);
+    links = names + h->count;
+    tags = (const Tag *)(links + h->linksSize);
+    files = (const File *)(tags + h->tagsSize);
+    strings = (const char *)(files + h->filesSize);
+    if(!isConsistent())
+	{
+	close();
+	return false;
+	}
+    return true;
+}
+
+// is #first#, #n# a range of a block of #size# elements?
+static inline bool inRange(unsigned int first, unsigned int n,
+    unsigned int size)
+{
+    return first <= size && n <= size - first;
+}
+
+bool DocDBFile::isConsistent() const
+{
+    const unsigned int count = header->count;
+    const unsigned int size = header->stringsSize;
+    unsigned int i;
+
+    // the last string ends the block, so all strings end inside it
+    for(i = 0; i < count; i++)
+	{
+	const Record& r = records[i];
+	if(r.name >= size || r.fullName >= size || r.type >= size ||
+	    r.args >= size || r.memo >= size || r.doc >= size ||
+	    r.file >= size || (r.parent >= count && r.parent != none) ||
+	    !inRange(r.members, r.numMembers, header->linksSize) ||
+	    !inRange(r.bases, r.numBases, header->linksSize) ||
+	    !inRange(r.subclasses, r.numSubclasses, header->linksSize) ||
+	    !inRange(r.tags, r.numTags, header->tagsSize) ||
+	    names[i] >= count)
+	    return false;
+	}
+    for(i = 0; i < header->linksSize; i++)
+	if(links[i] >= count)
+	    return false;
+    for(i = 0; i < header->tagsSize; i++)
+	if(tags[i].text >= size)
+	    return false;
+    for(i = 0; i < header->filesSize; i++)
+	if(files[i].name >= size ||
+	    !inRange(files[i].entries, files[i].numEntries, header->linksSize))
+	    return false;
+    return true;
+}
+
+void DocDBFile::close()
+{
+    data.close();
+    header = 0;
+    records = 0;
+    names = 0;
+    links = 0;
+    tags = 0;
+    files = 0;
+    strings = 0;
+}
+
+int DocDBFile::find(const char *fullName, int *first) const
+{
+    int lo = 0, hi = num();
+
+    // the first entry not before #fullName#
+    while(lo < hi)
+	{
+	int mid = (lo + hi) / 2;
+	if(strcmp(strings + records[names[mid]].fullName, fullName) < 0)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+	}
+    *first = lo;
+    for(hi = lo; hi < num() &&
+	strcmp(strings + records[names[hi]].fullName, fullName) == 0; hi++)
+	;
+    return hi - lo;
+}
+
+const DocDBFile::File *DocDBFile::findFile(const char *name) const
+{
+    int lo = 0, hi = numFiles();
+
+    while(lo < hi)
+	{
+	int mid = (lo + hi) / 2;
+	int c = strcmp(strings + files[mid].name, name);
+	if(c == 0)
+	    return files + mid;
+	if(c < 0)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+	}
+    return 0;
+}
+
+/* Writing
+ */
+
+/// An entry and its number, sorted by address to find the number
+struct EntryNumber
+{
+    const Entry *entry;
+    unsigned int number;
+};
+
+class EntryNumberCompare
+{
+public:
+    int operator()(const EntryNumber& n1, const EntryNumber& n2)
+	{
+	return n1.entry < n2.entry ? -1 : (n1.entry > n2.entry ? 1 : 0);
+	}
+};
+
+/// Orders entry numbers by a string of the entries, then by number
+class EntryStringCompare
+{
+public:
+    EntryStringCompare(const McDArray<Entry *>& e, McString Entry::*f)
+	: entries(e), field(f)
+	{
+	}
+
+    int operator()(const unsigned int& i1, const unsigned int& i2)
+	{
+	int c = strcmp((entries[i1]->*field).c_str(),
+	    (entries[i2]->*field).c_str());
+	return c ? c : (i1 < i2 ? -1 : (i1 > i2 ? 1 : 0));
+	}
+
+private:
+    const McDArray<Entry *>& entries;
+    McString Entry::*field;
+};
+
+/// The blocks of a database while they are collected from the tree
+class DocDBWriter
+{
+public:
+    McDArray<Entry *>			entries;	// depth first
+    McDArray<EntryNumber>		numbers;
+    McDArray<DocDBFile::Record>		records;
+    McDArray<unsigned int>		names;
+    McDArray<unsigned int>		links;
+    McDArray<DocDBFile::Tag>		tags;
+    McDArray<DocDBFile::File>		files;
+    McDArray<char>			strings;
+
+    DocDBWriter() : pool(-1)
+	{
+	// offset 0 is the empty string
+	strings.append('\0');
+	}
+
+    void collect(Entry *e)
+	{
+	entries.append(e);
+	for(int i = 0; i < e->sublist().size(); i++)
+	    collect(e->sublist()[i]);
+	}
+
+    void number();
+
+    unsigned int numberOf(const Entry *e) const;
+
+    unsigned int addString(const char *s);
+
+    void addLinks(const McDArray<Entry *>& list)
+	{
+	for(int i = 0; i < list.size(); i++)
+	    {
+	    unsigned int n = numberOf(list[i]);
+	    if(n != DocDBFile::none)
+		links.append(n);
+	    }
+	}
+
+    void addTag(unsigned int kind, const McString& text)
+	{
+	if(text.length() > 0)
+	    {
+	    DocDBFile::Tag t;
+	    t.kind = kind;
+	    t.text = addString(text.c_str());
+	    tags.append(t);
+	    }
+	}
+
+    void addTags(unsigned int kind, const McDArray<McString *>& list)
+	{
+	for(int i = 0; i < list.size(); i++)
+	    addTag(kind, *list[i]);
+	}
+
+    void addRecord(Entry *e);
+
+    void addFiles();
+
+private:
+    // strings of the tree already in the string block, at which offset
+    McHashTable<const char *, int> pool;
+};
+
+void DocDBWriter::number()
+{
+    EntryNumberCompare comp;
+
+    numbers.resize(entries.size());
+    for(int i = 0; i < entries.size(); i++)
+	{
+	numbers[i].entry = entries[i];
+	numbers[i].number = i;
+	}
+    if(numbers.size() > 1)
+	sort((EntryNumber *)numbers, numbers.size(), comp);
+}
+
+unsigned int DocDBWriter::numberOf(const Entry *e) const
+{
+    int lo = 0, hi = numbers.size();
+
+    while(lo < hi)
+	{
+	int mid = (lo + hi) / 2;
+	if(numbers[mid].entry == e)
+	    return numbers[mid].number;
+	if(numbers[mid].entry < e)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+	}
+    return DocDBFile::none;
+}
+
+unsigned int DocDBWriter::addString(const char *s)
+{
+    if(s == 0 || *s == 0)
+	return 0;
+
+    int *known = pool.lookup(s);
+    if(known)
+	return *known;
+
+    unsigned int offset = strings.size();
+    strings.append(strlen(s) + 1, s);
+    pool.insert(s, offset);
+    return offset;
+}
+
+void DocDBWriter::addRecord(Entry *e)
+{
+    const EntryExtra& x = e->constExtra();
+    DocDBFile::Record r;
+
+    memset(&r, 0, sizeof(r));
+    r.name = addString(e->name.c_str());
+    r.fullName = addString(e->fullName.c_str());
+    r.type = addString(e->type.c_str());
+    r.args = addString(e->args.c_str());
+    r.memo = addString(e->memo.c_str());
+    r.doc = addString(e->doc.c_str());
+    r.file = addString(e->file.c_str());
+    r.line = e->startLine;
+    r.parent = e->parent ? numberOf(e->parent) : DocDBFile::none;
+    r.section = e->section;
+    r.protection = e->protection;
+
+    r.members = links.size();
+    addLinks(e->sublist());
+    r.numMembers = links.size() - r.members;
+
+    r.bases = links.size();
+    addLinks(x.pubBaseclasses);
+    addLinks(x.proBaseclasses);
+    addLinks(x.priBaseclasses);
+    r.numBases = links.size() - r.bases;
+
+    r.subclasses = links.size();
+    addLinks(x.pubChilds);
+    addLinks(x.proChilds);
+    addLinks(x.priChilds);
+    r.numSubclasses = links.size() - r.subclasses;
+
+    r.tags = tags.size();
+    addTag(DocDBFile::TAG_AUTHOR, x.author);
+    addTag(DocDBFile::TAG_VERSION, x.version);
+    addTag(DocDBFile::TAG_DEPRECATED, x.deprecated);
+    addTag(DocDBFile::TAG_SINCE, x.since);
+    addTags(DocDBFile::TAG_SEE, x.see);
+    addTags(DocDBFile::TAG_PARAM, x.param);
+    addTags(DocDBFile::TAG_FIELD, x.field);
+    addTags(DocDBFile::TAG_EXCEPTION, x.exception);
+    addTags(DocDBFile::TAG_RETURN, x.retrn);
+    addTags(DocDBFile::TAG_PRECONDITION, x.precondition);
+    addTags(DocDBFile::TAG_POSTCONDITION, x.postcondition);
+    addTags(DocDBFile::TAG_INVARIANT, x.invariant);
+    addTags(DocDBFile::TAG_FRIEND, x.friends);
+    addTags(DocDBFile::TAG_OTHER_BASE, x.otherPubBaseclasses);
+    addTags(DocDBFile::TAG_OTHER_BASE, x.otherProBaseclasses);
+    addTags(DocDBFile::TAG_OTHER_BASE, x.otherPriBaseclasses);
+    r.numTags = tags.size() - r.tags;
+
+    records.append(r);
+}
+
+void DocDBWriter::addFiles()
+{
+    McDArray<unsigned int> byFile;
+    EntryStringCompare comp(entries, &Entry::file);
+    int i, j;
+
+    for(i = 0; i < entries.size(); i++)
+	if(entries[i]->file.length() > 0)
+	    byFile.append(i);
+    if(byFile.size() > 1)
+	sort((unsigned int *)byFile, byFile.size(), comp);
+
+    for(i = 0; i < byFile.size(); i = j)
+	{
+	DocDBFile::File f;
+	f.name = records[byFile[i]].file;
+	f.entries = links.size();
+	for(j = i; j < byFile.size() && records[byFile[j]].file == f.name; j++)
+	    links.append(byFile[j]);
+	f.numEntries = j - i;
+	files.append(f);
+	}
+}
+
+bool DocDBFile::write(const char *path, Entry *root)
+{
+    DocDBWriter w;
+    Header h;
+    int i;
+
+    w.collect(root);
+    w.number();
+    for(i = 0; i < w.entries.size(); i++)
+	w.addRecord(w.entries[i]);
+
+    EntryStringCompare comp(w.entries, &Entry::fullName);
+    w.names.resize(w.entries.size());
+    for(i = 0; i < w.names.size(); i++)
+	w.names[i] = i;
+    if(w.names.size() > 1)
+	sort((unsigned int *)w.names, w.names.size(), comp);
+
+    w.addFiles();
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, docDBMagic, 8);
+    h.version = docDBVersion;
+    h.byteOrder = docDBByteOrder;
+    h.count = w.records.size();
+    h.linksSize = w.links.size();
+    h.tagsSize = w.tags.size();
+    h.filesSize = w.files.size();
+    h.stringsSize = w.strings.size();
+
+    FILE *out = fopen(path, "wb");
+    if(!out)
+	return false;
+
+    fwrite(&h, sizeof(h), 1, out);
+    if(w.records.size())
+	{
+	fwrite((Record *)w.records, sizeof(Record), w.records.size(), out);
+	fwrite((unsigned int *)w.names, sizeof(unsigned int), w.names.size(),
+	    out);
+	}
+    if(w.links.size())
+	fwrite((unsigned int *)w.links, sizeof(unsigned int), w.links.size(),
+	    out);
+    if(w.tags.size())
+	fwrite((Tag *)w.tags, sizeof(Tag), w.tags.size(), out);
+    if(w.files.size())
+	fwrite((File *)w.files, sizeof(File), w.files.size(), out);
+    fwrite((char *)w.strings, 1, w.strings.size(), out);
+
+    // a failed fwrite() sets the error flag, which fclose() does not report
+    bool ok = !ferror(out);
+    if(fclose(out) != 0 || !ok)
+	{
+	remove(path);
+	return false;
+	}
+    return true;
+}
+
+/* Queries
+ */
+
+static const char *sectionName(unsigned short section)
+{
+    static const struct
+	{
+	unsigned short section;
+	const char *name;
+	} names[] =
+	{
+	{ MANUAL_SEC,		"manual" },
+	{ VARIABLE_SEC,		"variable" },
+	{ FUNCTION_SEC,		"function" },
+	{ MACRO_SEC,		"macro" },
+	{ CLASS_SEC,		"class" },
+	{ UNION_SEC,		"union" },
+	{ INTERFACE_SEC,	"interface" },
+	{ PACKAGE_SEC,		"package" },
+	{ TYPEDEF_SEC,		"typedef" },
+	{ NAMESPACE_SEC,	"namespace" }
+	};
+
+    for(unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+	if(section & names[i].section)
+	    return names[i].name;
+    return "entry";
+}
+
+static const char *protectionName(char protection)
+{
+    switch(protection)
+	{
+	case PROT:
+	    return "protected";
+	case PRIV:
+	    return "private";
+	default:
+	    return "public";
+	}
+}
+
+static const char *tagName(unsigned int kind)
+{
+    static const char *names[] = { "?", "author", "version", "deprecated",
+	"since", "see", "param", "field", "exception", "return",
+	"precondition", "postcondition", "invariant", "friend", "base" };
+
+    return kind < sizeof(names) / sizeof(names[0]) ? names[kind] : "?";
+}
+
+// prints #str# on one line, with `\', newlines and tabs escaped
+static void printEscaped(const char *str)
+{
+    for(; *str; str++)
+	switch(*str)
+	    {
+	    case '\\':
+		fputs("\\\\", stdout);
+		break;
+	    case '\n':
+		fputs("\\n", stdout);
+		break;
+	    case '\t':
+		fputs("\\t", stdout);
+		break;
+	    default:
+		putchar(*str);
+	    }
+}
+
+/// prints entry #i# as `full name and arguments, kind, protection, file:line'
+static void printEntry(const DocDBFile& db, unsigned int i)
+{
+    const DocDBFile::Record& r = db.entry(i);
+
+    printEscaped(db.string(r.fullName));
+    printEscaped(db.string(r.args));
+    printf("\t%s\t%s\t", sectionName(r.section),
+	protectionName(r.protection));
+    printEscaped(db.string(r.file));
+    printf(":%d\n", r.line);
+}
+
+static void printField(const char *field, const char *value)
+{
+    if(*value)
+	{
+	printf("%s\t", field);
+	printEscaped(value);
+	putchar('\n');
+	}
+}
+
+static void printDetails(const DocDBFile& db, unsigned int i)
+{
+    const DocDBFile::Record& r = db.entry(i);
+    unsigned int j;
+
+    printEntry(db, i);
+    printField("type", db.string(r.type));
+    printField("memo", db.string(r.memo));
+    printField("doc", db.string(r.doc));
+    for(j = 0; j < r.numTags; j++)
+	{
+	const DocDBFile::Tag& t = db.tag(r.tags + j);
+	printField(tagName(t.kind), db.string(t.text));
+	}
+}
+
+// prints the #n# entries from #first# on in the link block
+static int printLinks(const DocDBFile& db, unsigned int first, unsigned int n)
+{
+    for(unsigned int i = 0; i < n; i++)
+	printEntry(db, db.link(first + i));
+    return n;
+}
+
+// answers query #what# for #name#, returns the nr. of lines printed
+static int query(const DocDBFile& db, const char *what, const char *name)
+{
+    int found = 0;
+    int first, n, i;
+
+    if(strcmp(what, "file") == 0)
+	{
+	const DocDBFile::File *f = db.findFile(name);
+	if(f)
+	    return printLinks(db, f->entries, f->numEntries);
+
+	// all files whose path ends with #name#
+	int len = strlen(name);
+	for(i = 0; i < db.numFiles(); i++)
+	    {
+	    const char *path = db.string(db.file(i).name);
+	    int plen = strlen(path);
+	    if(plen > len && strcmp(path + plen - len, name) == 0 &&
+		(path[plen - len - 1] == '/' || path[plen - len - 1] == '\\'))
+		found += printLinks(db, db.file(i).entries,
+		    db.file(i).numEntries);
+	    }
+	return found;
+	}
+
+    n = db.find(name, &first);
+    for(i = first; i < first + n; i++)
+	{
+	const DocDBFile::Record& r = db.entry(db.byName(i));
+
+	if(strcmp(what, "name") == 0)
+	    {
+	    printEntry(db, db.byName(i));
+	    found++;
+	    }
+	else
+	    if(strcmp(what, "show") == 0)
+		{
+		printDetails(db, db.byName(i));
+		found++;
+		}
+	    else
+		if(strcmp(what, "members") == 0)
+		    found += printLinks(db, r.members, r.numMembers);
+		else
+		    if(strcmp(what, "bases") == 0)
+			{
+			found += printLinks(db, r.bases, r.numBases);
+			for(unsigned int j = 0; j < r.numTags; j++)
+			    if(db.tag(r.tags + j).kind == DocDBFile::TAG_OTHER_BASE)
+				{
+				printEscaped(db.string(db.tag(r.tags + j).text));
+				putchar('\n');
+				found++;
+				}
+			}
+		    else
+			found += printLinks(db, r.subclasses, r.numSubclasses);
+	}
+    return found;
+}
+
+int queryDocDB(const char *path, char **args, int n)
+{
+    static const char *queries[] = { "name", "show", "file", "members",
+	"bases", "subclasses" };
+    DocDBFile db;
+    int status = 0;
+    int i;
+    unsigned int j;
+
+    if(n == 0 || n % 2)
+	{
+	fprintf(stderr, _("Usage: doc++ --query FILE QUERY NAME...\n"));
+	return 2;
+	}
+    for(i = 0; i < n; i += 2)
+	{
+	for(j = 0; j < sizeof(queries) / sizeof(queries[0]); j++)
+	    if(strcmp(args[i], queries[j]) == 0)
+		break;
+	if(j == sizeof(queries) / sizeof(queries[0]))
+	    {
+	    fprintf(stderr, _("Unknown query `%s'. Try `doc++ --help'\n"),
+		args[i]);
+	    return 2;
+	    }
+	}
+    if(!db.open(path))
+	{
+	fprintf(stderr, _("Can't read documentation database `%s'\n"), path);
+	return 2;
+	}
+
+    for(i = 0; i < n; i += 2)
+	{
+	if(i > 0)
+	    putchar('\n');
+	if(query(db, args[i], args[i + 1]) == 0)
+	    status = 1;
+	}
+    return status;
+}
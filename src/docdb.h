@@ -0,0 +1,211 @@
+/*
+  docdb.h
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this program; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef _DOC_DB_H
+#define _DOC_DB_H
+
+#include "McMappedFile.h"
+
+class Entry;
+
+/** Read-only view of a documentation database written with #--db#.
+
+    The file holds the resolved tree of entries: a header, the table of
+    entries in depth first order with the root first, the entries sorted by
+    full name, one array of entry numbers for the members, base classes and
+    subclasses of all entries, the tags of all entries, the table of source
+    files sorted by name and one block with all strings. Strings and lists
+    are given as positions in these blocks, so the file is used in place
+    after #open()# has mapped it, without building anything in memory.
+*/
+class DocDBFile
+{
+public:
+    /// binary layout of the file header
+    struct Header
+	{
+	char magic[8];
+	unsigned int version;
+	unsigned int byteOrder;
+	unsigned int count;		// nr. of entries
+	unsigned int linksSize;		// nr. of entry numbers in the link block
+	unsigned int tagsSize;		// nr. of tags
+	unsigned int filesSize;		// nr. of source files
+	unsigned int stringsSize;	// size of the string block in bytes
+	};
+
+    /// binary layout of one entry, strings are offsets in the string block
+    struct Record
+	{
+	unsigned int name;
+	unsigned int fullName;
+	unsigned int type;
+	unsigned int args;
+	unsigned int memo;
+	unsigned int doc;
+	unsigned int file;
+	int line;
+	unsigned int parent;		// nr. of the parent, #none# for the root
+	unsigned int members;		// first member in the link block
+	unsigned int numMembers;
+	unsigned int bases;		// first base class in the link block
+	unsigned int numBases;
+	unsigned int subclasses;	// first subclass in the link block
+	unsigned int numSubclasses;
+	unsigned int tags;		// first tag
+	unsigned int numTags;
+	unsigned short section;		// see #_SectionType#
+	char protection;		// see #PROTECTION#
+	char pad;
+	};
+
+    /// kinds of tags
+    enum TagKind
+	{
+	TAG_AUTHOR = 1,
+	TAG_VERSION,
+	TAG_DEPRECATED,
+	TAG_SINCE,
+	TAG_SEE,
+	TAG_PARAM,
+	TAG_FIELD,
+	TAG_EXCEPTION,
+	TAG_RETURN,
+	TAG_PRECONDITION,
+	TAG_POSTCONDITION,
+	TAG_INVARIANT,
+	TAG_FRIEND,
+	TAG_OTHER_BASE		// name of a base class that is not documented
+	};
+
+    /// binary layout of one tag
+    struct Tag
+	{
+	unsigned int kind;		// see #TagKind#
+	unsigned int text;
+	};
+
+    /// binary layout of one source file, its entries are in the link block
+    struct File
+	{
+	unsigned int name;
+	unsigned int entries;
+	unsigned int numEntries;
+	};
+
+    /// entry number meaning no entry
+    static const unsigned int none = 0xffffffff;
+
+    /** Map #path#, returns #false# if it is not a documentation database
+	or if any of its numbers or offsets point outside of their block.
+     */
+    bool open(const char *path);
+
+    void close();
+
+    bool isOpen() const
+	{
+	return header != 0;
+	}
+
+    ///	return nr. of entries
+    int num() const
+	{
+	return header ? (int)header->count : 0;
+	}
+
+    /// return the #i#-th entry, the root is entry 0
+    const Record& entry(unsigned int i) const
+	{
+	return records[i];
+	}
+
+    /// return the string at #offset# in the string block
+    const char *string(unsigned int offset) const
+	{
+	return strings + offset;
+	}
+
+    /// return the #i#-th entry number of the link block
+    unsigned int link(unsigned int i) const
+	{
+	return links[i];
+	}
+
+    /// return the #i#-th tag
+    const Tag& tag(unsigned int i) const
+	{
+	return tags[i];
+	}
+
+    /** Find the entries named #fullName#. Returns the nr. of them, the
+	first is the #*first#-th entry in full name order, see #byName()#.
+     */
+    int find(const char *fullName, int *first) const;
+
+    /// return the nr. of the #i#-th entry in full name order
+    unsigned int byName(int i) const
+	{
+	return names[i];
+	}
+
+    /// return the source file named #name#, or 0 if there is none
+    const File *findFile(const char *name) const;
+
+    ///	return nr. of source files
+    int numFiles() const
+	{
+	return header ? (int)header->filesSize : 0;
+	}
+
+    /// return the #i#-th source file in name order
+    const File& file(int i) const
+	{
+	return files[i];
+	}
+
+    /// Write the tree below #root# to #path#
+    static bool write(const char *path, Entry *root);
+
+    DocDBFile() : header(0), records(0), names(0), links(0), tags(0),
+	files(0), strings(0)
+	{
+	}
+
+private:
+    bool isConsistent() const;
+
+    McMappedFile data;
+    const Header *header;
+    const Record *records;
+    const unsigned int *names;
+    const unsigned int *links;
+    const Tag *tags;
+    const File *files;
+    const char *strings;
+};
+
+/** Answer the queries #args[0..n-1]# of #doc++ --query# from the database
+    #path#. Each query is a keyword and a name, see the manual. Returns the
+    exit status.
+*/
+extern int queryDocDB(const char *path, char **args, int n);
+
+#endif
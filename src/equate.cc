@@ -37,8 +37,10 @@
 #include <unistd.h>
 #endif
 
+#include "McDirectory.h"
 #include "McString.h"
 #include "doc.h"
+#include "nametable.h"
 #include "tex2gif.h"
 
 #define EQUATE_VERSION	"0.1"
@@ -50,6 +52,8 @@ void help()
 	EQUATE_VERSION);
     printf(_("Usage: equate [options] [gifdb_file]\n\n"));
     printf(_("Options:\n"));
+    printf(_("  -c  --convert          convert a GIF database from the old text format\n"));
+    printf(_("                         and exit\n"));
     printf(_("  -d  --dir DIR          use DIR for the output directory\n"));
     printf(_("  -f  --file FILE        read FILE instead of gif.db as GIF database\n"));
     printf(_("                         (relative to . or DIR)\n\n"));
@@ -67,9 +71,11 @@ main(int argc, char** argv)
 {       
     McString dir = ".";
     McString gifdb = "gifs.db";
+    bool convert = false;
     int c;
 
     static struct option long_options[] = {
+	{ "convert", no_argument, 0, 'c' },
 	{ "dir", required_argument, 0, 'd' },
 	{ "file", required_argument, 0, 'f' },
 	{ "help", no_argument, 0, 'h' },
@@ -79,9 +85,12 @@ main(int argc, char** argv)
 
     opterr = 0;
 
-    while((c = getopt_long(argc, argv, "+:d:fhV", long_options, (int *)0)) != EOF)
+    while((c = getopt_long(argc, argv, "+:cd:f:hV", long_options, (int *)0)) != EOF)
 	switch(c)
 	    {
+	    case 'c':
+		convert = true;
+		break;
 	    case 'd':
 		if(optarg[0] == '-')
 		    {
@@ -106,5 +115,33 @@ main(int argc, char** argv)
 		exit(0);
 	    }
 
+    if(convert)
+	{
+	McString path(dir);
+	path += PATH_DELIMITER;
+	path += gifdb;
+
+	NameTableFile db;
+	if(db.open(path.c_str()))
+	    {
+	    printf(_("`%s' is already in binary format\n"), path.c_str());
+	    exit(0);
+	    }
+	if(NameTableFile::isBinary(path.c_str()))
+	    {
+	    fprintf(stderr, _("`%s' is a damaged binary database\n"),
+		path.c_str());
+	    exit(1);
+	    }
+	int n = NameTableFile::convert(path.c_str(), path.c_str());
+	if(n < 0)
+	    {
+	    fprintf(stderr, _("Can't convert `%s'\n"), path.c_str());
+	    exit(1);
+	    }
+	printf(_("Converted %d GIF record(s)\n"), n);
+	exit(0);
+	}
+
     makeGifs(dir, gifdb);
 }
@@ -45,6 +45,7 @@
 #include "doc.h"
 #include "gifs.h"
 #include "java.h"
+#include "stats.h"
 
 #define max(a, b) ((a) > (b) ? (a) : (b))
 
@@ -54,6 +55,9 @@ static McString header, footer;
 static char *GENERAL_NAME = "General";
 FILE *generalf;
 
+static bool haveManualRootSec = false;	// a group is written to index.html
+static bool haveClassGraphs;		// there is a class hierarchy to write
+
 static char *docType = "<!DOCTYPE HTML PUBLIC \"-//W3C//DTD HTML 4.0 Transitional//EN\">\n\n";
 static McString styleSheet;
 
@@ -70,6 +74,8 @@ static McString pageFooter;
 static McString pageFooterJava;
 
 void writeTOCentry(FILE *f, Entry *e, bool memo, bool dup = false);
+static void needHtml(Entry *entry);
+static void releaseHtml();
 
 int makedir(const char *d, int perm)
 {
@@ -128,9 +134,7 @@ void buildHeaders()
 // Initializes HTML footers
 void buildFooters()
 {
-    bool generateClassGraphs = !noClassGraph && relevantClassGraphs(root);
-
-    if(generateClassGraphs)
+    if(haveClassGraphs)
 	{
 	indexFooter =	"<P><I><A HREF=\"HIER";
 	indexFooter +=	htmlSuffix;
@@ -144,7 +148,7 @@ void buildFooters()
     pageFooter =	"<P><I><A HREF=\"index";
     pageFooter +=	htmlSuffix;
     pageFooter +=	_("\">Alphabetic index</A></I>");
-    if(generateClassGraphs)
+    if(haveClassGraphs)
 	{
 	pageFooter +=	" <I><A HREF=\"HIER";
 	pageFooter +=	htmlSuffix;
@@ -155,7 +159,7 @@ void buildFooters()
     pageFooterJava =	"<P><I><A HREF=\"index";
     pageFooterJava +=	htmlSuffix;
     pageFooterJava +=	_("\">Alphabetic index</A></I>");
-    if(generateClassGraphs)
+    if(haveClassGraphs)
 	{
 	pageFooterJava +=	" <I><A HREF=\"HIER";
 	pageFooterJava +=	htmlSuffix;
@@ -167,9 +171,11 @@ void buildFooters()
     pageFooterJava +=	"</P>";
 }
 
+// Lowercase names of all generated pages, with their number of uses
+static McHashTable<char *,int> files(1);
+
 McString makeFileName(const McString& str, Entry *e)
 {
-    static McHashTable<char *,int> files(1);
     McString s, ls;
     char buf[40];
     int i, l = str.length();
@@ -227,6 +233,7 @@ void htmlComment(FILE *f, Entry *e, int t)
     char start[] = "<BLOCKQUOTE>";
     char end[] = "</BLOCKQUOTE>";
 
+    needHtml(e);
     if((t & DOC) && e->doc.length() > 1)
 	{
 	fprintf(f, "%s%s%s\n", start, (e->hdoc), end);
@@ -238,13 +245,14 @@ void htmlComment(FILE *f, Entry *e, int t)
 
 int subEntryIsToBeDocumented(Entry *entry)
 {
+    const EntryExtra& x = entry->constExtra();
     bool toBeDocumented = false;
 
     if(entry->protection != PRIV || withPrivate)
 	{
-	if(entry->retrn.size() || entry->field.size() ||
-	    entry->param.size() || entry->author.length() ||
-	    entry->see.size() || entry->version.length())
+	if(x.retrn.size() || x.field.size() ||
+	    x.param.size() || x.author.length() ||
+	    x.see.size() || x.version.length())
 	    toBeDocumented = true;
 	if(entry->doc.length() > entry->memo.length() || 
 	    (entry->doc.length() == entry->memo.length() &&
@@ -571,17 +579,18 @@ HIERlist::~HIERlist()
 
 void writeHIERentry(HIERlist &list, FILE *f, Entry *entry)
 {
+    const EntryExtra& x = entry->constExtra();
     int i;
     HIERlist *sub = 0;
 
-    if(entry->pubChilds.size() > 0 || entry->proChilds.size() > 0)
+    if(x.pubChilds.size() > 0 || x.proChilds.size() > 0)
 	{
 	sub = new HIERlist();
 
-	for(i = 0; i < entry->pubChilds.size(); i++)
-	    writeHIERentry(*sub, f, entry->pubChilds[i]);
-	for(i = 0; i < entry->proChilds.size(); i++)
-	    writeHIERentry(*sub, f, entry->proChilds[i]);
+	for(i = 0; i < x.pubChilds.size(); i++)
+	    writeHIERentry(*sub, f, x.pubChilds[i]);
+	for(i = 0; i < x.proChilds.size(); i++)
+	    writeHIERentry(*sub, f, x.proChilds[i]);
 	}
 
     list.addEntry(entry, sub);
@@ -591,14 +600,14 @@ void writeHIERrec(HIERlist &list, FILE *f, Entry *entry)
 {
     int i;
 
-    for(i = 0; i < entry->sublist.size(); i++)
+    for(i = 0; i < entry->sublist().size(); i++)
 	{
-	if(entry->sublist[i]->baseclasses.size() == 0)
-	    if(entry->sublist[i]->isClass() &&
-		entry->sublist[i]->proBaseclasses.size() == 0 &&
-		entry->sublist[i]->pubBaseclasses.size() == 0)
-		writeHIERentry(list, f, entry->sublist[i]);
-	writeHIERrec(list, f, entry->sublist[i]);
+	if(entry->sublist()[i]->constExtra().baseclasses.size() == 0)
+	    if(entry->sublist()[i]->isClass() &&
+		entry->sublist()[i]->constExtra().proBaseclasses.size() == 0 &&
+		entry->sublist()[i]->constExtra().pubBaseclasses.size() == 0)
+		writeHIERentry(list, f, entry->sublist()[i]);
+	writeHIERrec(list, f, entry->sublist()[i]);
 	}
 }
 
@@ -625,11 +634,11 @@ void writeHIER(FILE *f)
 
 void MemberWriter::showSubMembers(Entry *e)
 {
-    Entry *tmp;
+    int i;
 
     fprintf(f, "%s\n", startString());
-    for(tmp = e->sub; tmp; tmp = tmp->next)
-	writeMember(tmp, true);
+    for(i = 0; i < e->subEntries.size(); i++)
+	writeMember(e->subEntries[i], true);
     fprintf(f, "%s\n", endString());
 }
 
@@ -642,6 +651,7 @@ void printRefLabel(FILE *f, Entry *entry)
 
 void MemberWriter::writeMember(Entry *entry, bool link, bool withSub)
 {
+    needHtml(entry);
     if(first)
 	{
 	fprintf(f, "%s\n%s", startString(), heading.c_str());
@@ -684,7 +694,7 @@ void MemberWriter::writeMember(Entry *entry, bool link, bool withSub)
 	    fprintf(f, "<DD><I>%s</I>\n", entry->hmemo);
 	}
 
-    if(entry->sub && withSub)
+    if(entry->subEntries.size() && withSub)
 	showSubMembers(entry);
 }
 
@@ -717,6 +727,7 @@ void MemberWriterTable::writeMember(Entry *entry, bool link, bool withSub)
 {
     char *args, *type;
 
+    needHtml(entry);
     if(first)
 	{
 	fprintf(f, "%s\n%s", startString(), heading.c_str());
@@ -761,7 +772,7 @@ void MemberWriterTable::writeMember(Entry *entry, bool link, bool withSub)
 	    fprintf(f, "\n<I>%s</I>\n", entry->hmemo);
 	}
 
-    if(entry->sub && withSub)
+    if(entry->subEntries.size() && withSub)
 	showSubMembers(entry);
 
     fprintf(f, "</TD></TR>");
@@ -769,22 +780,16 @@ void MemberWriterTable::writeMember(Entry *entry, bool link, bool withSub)
 
 void ClassGraphWriter::writeJava(FILE *f, Entry *entry, bool directOnly)
 {
-    ClassGraph cg(entry, 0);
-    ClassGraph *cls = &cg;
+    const ClassGraphLayout& cg = ClassGraphLayout::of(entry, !directOnly);
     McString classes, before, after, indent;
     char first = 1;
     int numLines = 0, longest = 0;
     char buf[40];
 
-    cg.addBases();
-
-    if(directOnly)
-	cg.addDirectChilds();
-    else
-	cg.addAllChilds();
-
-    for(cls = cg.firstLine; cls; cls = cls->nextLine)
+    for(int i = 0; i < cg.size(); i++)
 	{
+	const ClassGraph *cls = &cg[i];
+
 	numLines++;    
 	if(first)
 	    first = 0;
@@ -841,9 +846,9 @@ void ClassGraphWriter::writeText(FILE *f, Entry *e)
     int i;
     Entry *c;
 
-    for(i = 0; i < max(1, e->baseclasses.size()); i++)
+    for(i = 0; i < max(1, e->constExtra().baseclasses.size()); i++)
 	{
-	if(i < e->baseclasses.size() && e->baseclasses[i]->section == INTERFACE_SEC)
+	if(i < e->constExtra().baseclasses.size() && e->constExtra().baseclasses[i]->section == INTERFACE_SEC)
 	    {
 	    if(i == 0)
 		fprintf(f, "<H3>%s</H3>\n", e->hname);
@@ -851,12 +856,12 @@ void ClassGraphWriter::writeText(FILE *f, Entry *e)
 	    }
 	fprintf(f, "<H3>%s\n", e->hname);
 	c = e;
-	while(c->baseclasses.size() > 0)
+	while(c->constExtra().baseclasses.size() > 0)
 	    {
 	    if(c == e)
-		c = c->baseclasses[i];
+		c = c->constExtra().baseclasses[i];
 	    else
-		c = c->baseclasses[0];
+		c = c->constExtra().baseclasses[0];
 	    if(c)
 		fprintf(f, "- <A HREF=\"%s\">%s</A>\n",
 		    c->fileName.c_str(),
@@ -881,16 +886,16 @@ void ClassGraphWriter::writeImplements(FILE *f, Entry *e)
     int i, first = 1;
     Entry *c;
 
-    for(i = 0; i < e->baseclasses.size(); i++)
+    for(i = 0; i < e->constExtra().baseclasses.size(); i++)
 	{
-	if(e->baseclasses[i]->section != INTERFACE_SEC)
+	if(e->constExtra().baseclasses[i]->section != INTERFACE_SEC)
 	    continue;
 
 	if(first)
 	    fprintf(f, "<HR>\n<H2>Implements:</H2>\n");
 	first = 0;
 
-	c = e->baseclasses[i];
+	c = e->constExtra().baseclasses[i];
 	if(i > 0)
 	    fprintf(f, ", ");
 	if(c)
@@ -902,6 +907,7 @@ void ClassGraphWriter::writeImplements(FILE *f, Entry *e)
 
 extern char *strToHtml(McString &in, char *dest = 0, Entry *ct = 0, bool withLinks = false, bool pureCode = false);
 extern char *seeToHtml(McString &in, Entry *ct = 0);
+extern void freeHtml(char *html);
 
 void entry2link(McString& u, Entry *ref, const char *linkname)
 {
@@ -988,6 +994,7 @@ void writeTOCentry(McString& out, Entry *e, bool memo, bool dup = false)
     if(memo)
 	if(e->memo.length())
 	    {
+	    needHtml(e);
 	    out += " <I>";
 	    out += (const char *)e->hmemo;
 	    out += "</I>\n";
@@ -1006,17 +1013,18 @@ void writeTOCentry(FILE *f, Entry *e, bool memo, bool dup)
 
 void writeHIERentry(FILE *f, Entry *k, bool memo)
 {
+    const EntryExtra& x = k->constExtra();
     int i;
 
     fprintf(f, "<LI>");
     writeTOCentry(f, k, memo);
-    if(k->pubChilds.size() || k->proChilds.size())
+    if(x.pubChilds.size() || x.proChilds.size())
 	{
 	fprintf(f, "<UL>\n");
-	for(i = 0; i < k->pubChilds.size(); i++)
-	    writeHIERentry(f, k->pubChilds[i], memo);
-	for(i = 0; i < k->proChilds.size(); i++)
-	    writeHIERentry(f, k->proChilds[i], memo);
+	for(i = 0; i < x.pubChilds.size(); i++)
+	    writeHIERentry(f, x.pubChilds[i], memo);
+	for(i = 0; i < x.proChilds.size(); i++)
+	    writeHIERentry(f, x.proChilds[i], memo);
 	fprintf(f, "</UL>\n");
 	}
 }
@@ -1045,16 +1053,16 @@ void writeTOCRec(TOClist& list, FILE *f, Entry *root, int section, int& first)
 
     // Want to recurse down em all, but subtree only if output root
     TOClist *sub = 0;
-    if(root->sublist.size())
+    if(root->sublist().size())
 	{
 	if(output)
 	    sub = new TOClist();
 
-	for(i = 0; i < root->sublist.size(); i++)
+	for(i = 0; i < root->sublist().size(); i++)
 	    if(output)
-		writeTOCRec(*sub, f, root->sublist[i], section, first);
+		writeTOCRec(*sub, f, root->sublist()[i], section, first);
 	    else
-		writeTOCRec(list, f, root->sublist[i], section, first);
+		writeTOCRec(list, f, root->sublist()[i], section, first);
 	}
     if(output)
 	list.addEntry(root, sub);
@@ -1096,14 +1104,14 @@ void writeHIERrecJava(FILE *f, Entry *root)
 {
     int i;
 
-    for(i = 0; i < root->sublist.size(); i++)
+    for(i = 0; i < root->sublist().size(); i++)
 	{
-	if(root->sublist[i]->baseclasses.size() == 0)
-	    if(root->sublist[i]->isClass() &&
-		root->sublist[i]->proBaseclasses.size() == 0 &&
-		root->sublist[i]->pubBaseclasses.size() == 0)
-		ClassGraphWriter::writeJava(f, root->sublist[i], 0);
-	writeHIERrecJava(f, root->sublist[i]);
+	if(root->sublist()[i]->constExtra().baseclasses.size() == 0)
+	    if(root->sublist()[i]->isClass() &&
+		root->sublist()[i]->constExtra().proBaseclasses.size() == 0 &&
+		root->sublist()[i]->constExtra().pubBaseclasses.size() == 0)
+		ClassGraphWriter::writeJava(f, root->sublist()[i], 0);
+	writeHIERrecJava(f, root->sublist()[i]);
 	}
 }
 
@@ -1123,41 +1131,146 @@ void writeHIERjava(FILE *f)
     copyright(f);
 }
 
+// The sections of the member lists, their headings are in showMembers()
+static struct {
+    int protection;
+    int secMask;
+} memberSections[] = {
+  { PUBL, VARIABLE_SEC },
+  { PUBL, FUNCTION_SEC},
+  { PUBL, ~(VARIABLE_SEC | FUNCTION_SEC) },
+  { PROT, VARIABLE_SEC },
+  { PROT, FUNCTION_SEC },
+  { PROT, ~(VARIABLE_SEC | FUNCTION_SEC) },
+  { PRIV, VARIABLE_SEC },
+  { PRIV, FUNCTION_SEC },
+  { PRIV, ~(VARIABLE_SEC | FUNCTION_SEC) }};
+
+#define NUM_MEMBER_SECTIONS 9
+
+/** The members of a class sorted into #memberSections#, with their
+    signatures. This is made once for every class that is inherited from and
+    used on the pages of all classes derived from it.
+*/
+struct InheritedMembers
+{
+    /// indices of the sub-entries, section by section
+    McDArray<int>	order;
+
+    /// where each section starts in #order#, and its end
+    int			start[NUM_MEMBER_SECTIONS + 1];
+
+    /// the signature of each sub-entry, see #signatureId()#
+    McDArray<int>	signature;
+};
+
+void freeInheritedMembers(InheritedMembers *m)
+{
+    delete m;
+}
+
+// Signatures of members, numbered as they are first seen
+static McHashTable<const char *, int> signatures(-1);
+
+// For each signature, the class a member with it was listed for on the
+// page being written, 0 if none was
+static McDArray<Entry*> memberFathers;
+
+/* The number of the signature of a member. Overloaded members of Java and
+   PHP classes are told apart by their arguments, those of C++ classes are
+   not.
+*/
+static int signatureId(Entry *e)
+{
+    McString signature = e->name;
+    int *id;
+
+    if(language == LANG_JAVA || language == LANG_PHP)
+	signature += e->args;
+    if((id = signatures.lookup(signature.c_str())))
+	return *id;
+    signatures.insert(mcStrdup(signature.c_str(), MC_TAG_HTML),
+	memberFathers.size());
+    memberFathers.append(0);
+    return memberFathers.size() - 1;
+}
+
+// Sorts the members of #e# into the member list sections
+static void collectMembers(Entry *e, InheritedMembers& m)
+{
+    Entry *tmp, *type;
+    int i, j;
+
+    m.order.clear();
+    m.signature.clear();
+    for(j = 0; j < e->subEntries.size(); j++)
+	m.signature.append(signatureId(e->subEntries[j]));
+    for(i = 0; i < NUM_MEMBER_SECTIONS; i++)
+	{
+	m.start[i] = m.order.size();
+	for(j = 0; j < e->subEntries.size(); j++)
+	    {
+	    tmp = e->subEntries[j];
+	    type = tmp;
+	    if(tmp->section & MANUAL_SEC)
+		{
+		if(tmp->subEntries.size())
+		    type = tmp->subEntries[0];
+		else
+		    continue; // skip empty sections
+		}
+	    if(tmp->protection == memberSections[i].protection &&
+		(type->section & memberSections[i].secMask))
+		m.order.append(j);
+	    }
+	}
+    m.start[NUM_MEMBER_SECTIONS] = m.order.size();
+}
+
+// The members of a class as shown where it is inherited
+static InheritedMembers *inheritedMembers(Entry *e)
+{
+    EntryExtra& x = e->extra();
+
+    if(!x.inherited)
+	{
+	x.inherited = new InheritedMembers;
+	collectMembers(e, *x.inherited);
+	}
+    return x.inherited;
+}
+
 /** This class keeps track of overloading relationships. Insert mebers
     using addMember. It returns NULL in case this is a new Member, != 0
-    otherwise.
+    otherwise. Only one list may be in use at a time, as the classes are
+    kept in #memberFathers#.
 */
 class MemberList {
-	McHashTable<char *, Entry *> list;
+	McDArray<int> seen;	// signatures set in #memberFathers#
     public:
-	MemberList() : list((Entry *)NULL)
-	    {}
+	~MemberList()
+	    {
+	    for(int i = 0; i < seen.size(); i++)
+		memberFathers[seen[i]] = 0;
+	    }
 	/** Add a new member. Returns NULL, if no compatible member
 	    has yet occurred.
 	*/
-	Entry *addMember(Entry *e, Entry *father)
+	Entry *addMember(int signature, Entry *father)
 	    {
-	    McString signature = e->name;
-	    char *tmp;
-
-	    if(language == LANG_JAVA || language == LANG_PHP)
-		signature += e->args;
-	    tmp = strdup(signature.c_str());
-	    Entry **val = list.insert(tmp);
-	    if(*val == 0)
+	    Entry *&val = memberFathers[signature];
+
+	    if(val == 0)
 		{
-		*val = father;
+		val = father;
+		seen.append(signature);
 		return 0;
 		}
-	    else
-		{
 #ifdef DEBUG
-		if(verb)
-		    printf(_("Member `%s' was there\n"), tmp);
+	    if(verb)
+		printf(_("Member with signature %d was there\n"), signature);
 #endif
-		free(tmp);
-		}
-	    return *val;
+	    return val;
 	    }
 };
 
@@ -1165,63 +1278,59 @@ void showSubMembers(FILE *f, Entry *entry);
 
 void showMembers(Entry *e, FILE *f, int links, MemberList *ignore = 0)
 {
-    static struct {
-	char *heading;
-	int protection;
-	int secMask;
-    } sections[] = {
-      { _("<DT><H3>Public Fields</H3><DD>"), PUBL, VARIABLE_SEC },
-      { _("<DT><H3>Public Methods</H3><DD>"), PUBL, FUNCTION_SEC},
-      { _("<DT><H3>Public Members</H3><DD>"), PUBL, ~(VARIABLE_SEC | FUNCTION_SEC) },
-      { _("<DT><H3>Protected Fields</H3><DD>"), PROT, VARIABLE_SEC },
-      { _("<DT><H3>Protected Methods</H3><DD>"), PROT, FUNCTION_SEC },
-      { _("<DT><H3>Protected Members</H3><DD>"), PROT, ~(VARIABLE_SEC | FUNCTION_SEC) },
-      { _("<DT><H3>Private Fields</H3><DD>"), PRIV, VARIABLE_SEC },
-      { _("<DT><H3>Private Methods</H3><DD>"), PRIV, FUNCTION_SEC },
-      { _("<DT><H3>Private Members</H3><DD>"), PRIV, ~(VARIABLE_SEC | FUNCTION_SEC) },
-      { 0, 0, 0 }};
-
-    int i;
-    Entry *tmp, *type, *othersFather;
+    static char *headings[NUM_MEMBER_SECTIONS] = {
+      _("<DT><H3>Public Fields</H3><DD>"),
+      _("<DT><H3>Public Methods</H3><DD>"),
+      _("<DT><H3>Public Members</H3><DD>"),
+      _("<DT><H3>Protected Fields</H3><DD>"),
+      _("<DT><H3>Protected Methods</H3><DD>"),
+      _("<DT><H3>Protected Members</H3><DD>"),
+      _("<DT><H3>Private Fields</H3><DD>"),
+      _("<DT><H3>Private Methods</H3><DD>"),
+      _("<DT><H3>Private Members</H3><DD>") };
+
+    InheritedMembers own, *m;
+    int i, k;
+    Entry *tmp, *othersFather;
     MemberWriter *memberWriter;
     bool ignoreThisOne;
 
+    // a page lists the members of its own class only once
+    if(links)
+	{
+	collectMembers(e, own);
+	m = &own;
+	}
+    else
+	m = inheritedMembers(e);
+
     fprintf(f, "<DL>\n");
     if(withTables && links)
 	memberWriter = new MemberWriterTable();
     else
 	memberWriter = new MemberWriter();
-    for(i = 0; sections[i].heading; i++)
-	if(withPrivate || sections[i].protection != PRIV)
+    for(i = 0; i < NUM_MEMBER_SECTIONS; i++)
+	if(withPrivate || memberSections[i].protection != PRIV)
 	    {
-	    memberWriter->startList(f, sections[i].heading, links);
-	    for(tmp = e->sub; tmp; tmp = tmp->next)
+	    memberWriter->startList(f, headings[i], links);
+	    for(k = m->start[i]; k < m->start[i + 1]; k++)
 		{
-                type = tmp;
-                if(tmp->section & MANUAL_SEC)
-                    {
-                    if(tmp->sub) 
-                        type=tmp->sub;
-                    else
-                        continue; // skip empty sections
-                    }     
-		if(tmp->protection == sections[i].protection &&
-		    (type->section & sections[i].secMask))
-		    if(links ||
-			(tmp->name != e->name && (tmp->name[0] != '~' ||
-			    strcmp(tmp->name.c_str() + 1, e->name.c_str()) != 0)))
+		tmp = e->subEntries[m->order[k]];
+		if(links ||
+		    (tmp->name != e->name && (tmp->name[0] != '~' ||
+			strcmp(tmp->name.c_str() + 1, e->name.c_str()) != 0)))
+		    {
+		    ignoreThisOne = false;
+		    if(ignore)
 			{
-			ignoreThisOne = false;
-			if(ignore)
-			    {
-			    othersFather = ignore->addMember(tmp, e);
-			    if(othersFather != 0 && othersFather != e)
-				ignoreThisOne = true;
-			    }
-			bool withSub = (tmp->section == MANUAL_SEC && showMembersInTOC);
-			if(!ignoreThisOne || links)
-			    memberWriter->addMember(tmp, links, withSub);
+			othersFather = ignore->addMember(m->signature[m->order[k]], e);
+			if(othersFather != 0 && othersFather != e)
+			    ignoreThisOne = true;
 			}
+		    bool withSub = (tmp->section == MANUAL_SEC && showMembersInTOC);
+		    if(!ignoreThisOne || links)
+			memberWriter->addMember(tmp, links, withSub);
+		    }
 		}
 	    memberWriter->endList();
 	    }
@@ -1235,12 +1344,12 @@ void writeInherited(Entry *k, FILE *f, MemberList *list = 0)
     int i;
 
     showMembers(k, f, 0, list);
-    for(i = 0; i < k->baseclasses.size(); i++)
+    for(i = 0; i < k->constExtra().baseclasses.size(); i++)
 	{
 	fprintf(f, _("<HR><H3>Inherited from <A HREF=\"%s\">%s</A>:</H3>\n"),
-	    (k->baseclasses)[i]->fileName.c_str(),
-	    (k->baseclasses)[i]->hname);
-	writeInherited((k->baseclasses)[i], f, list);
+	    (k->constExtra().baseclasses)[i]->fileName.c_str(),
+	    (k->constExtra().baseclasses)[i]->hname);
+	writeInherited((k->constExtra().baseclasses)[i], f, list);
 	}
 }
 
@@ -1267,94 +1376,96 @@ void writeHTMLList(FILE *f, McDArray<McString *> list, char *description)
 */
 void writeTags(FILE *f, Entry *entry)
 {
+    const EntryExtra& x = entry->constExtra();
     int i, k;
 
+    needHtml(entry);
     fprintf(f, "<DL><DT>");
 
-    writeHTMLList(f, entry->invariant, "Invariants");
+    writeHTMLList(f, x.invariant, "Invariants");
 
-    if(entry->exception.size())
+    if(x.exception.size())
 	{
 	fprintf(f, _("<DT><B>Throws:</B><DD>"));
-	for(i = 0; i < entry->exception.size(); i++)
+	for(i = 0; i < x.exception.size(); i++)
 	    {
 	    k = 0;
 	    McString s;
-	    while(k < entry->exception[i]->length() &&
-		(myisalnum((*entry->exception[i])[k]) ||
-		(*entry->exception[i])[k] == '_' ||
-		(*entry->exception[i])[k] == '<' ||
-		(*entry->exception[i])[k] == '>' ||
-		(*entry->exception[i])[k] == ':'))
-		s += (*entry->exception[i])[k++];
+	    while(k < x.exception[i]->length() &&
+		(myisalnum((*x.exception[i])[k]) ||
+		(*x.exception[i])[k] == '_' ||
+		(*x.exception[i])[k] == '<' ||
+		(*x.exception[i])[k] == '>' ||
+		(*x.exception[i])[k] == ':'))
+		s += (*x.exception[i])[k++];
 	    fprintf(f, "<B>%s</B> ", strToHtml(s, 0, entry, true, true));
-	    while(k < entry->exception[i]->length())
-		fprintf(f, "%c", (*entry->exception[i])[k++]);
+	    while(k < x.exception[i]->length())
+		fprintf(f, "%c", (*x.exception[i])[k++]);
 	    fprintf(f, "<BR>");
 	    }
 	}
 
-    if(entry->param.size())
+    if(x.param.size())
 	{
 	fprintf(f, _("<DT><B>Parameters:</B><DD>"));
-	for(k = 0; k < entry->param.size(); k++)
+	for(k = 0; k < x.param.size(); k++)
 	    {
 	    i = 0;
 	    fprintf(f,"<B>");
-	    while(i < entry->param[k]->length() &&
-		(myisalnum((*entry->param[k])[i]) || 
-		(*entry->param[k])[i] == '_'))
-		fprintf(f, "%c", (*entry->param[k])[i++]);
+	    while(i < x.param[k]->length() &&
+		(myisalnum((*x.param[k])[i]) || 
+		(*x.param[k])[i] == '_'))
+		fprintf(f, "%c", (*x.param[k])[i++]);
 	    fprintf(f, "</B> - ");
 
-	    while(i < entry->param[k]->length())
-		fprintf(f, "%c", (*entry->param[k])[i++]);
+	    while(i < x.param[k]->length())
+		fprintf(f, "%c", (*x.param[k])[i++]);
 	    fprintf(f, "<BR>");
 	    }
 	}
 
-    if(entry->field.size())
+    if(x.field.size())
 	{
 	fprintf(f, _("<DT><B>Fields:</B><DD>"));
-	for(k = 0; k < entry->field.size(); k++)
+	for(k = 0; k < x.field.size(); k++)
 	    {
 	    i = 0;
 	    fprintf(f,"<B>");
-	    while(i < entry->field[k]->length() &&
-		(myisalnum((*entry->field[k])[i]) || 
-		(*entry->field[k])[i] == '_'))
-		fprintf(f, "%c", (*entry->field[k])[i++]);
+	    while(i < x.field[k]->length() &&
+		(myisalnum((*x.field[k])[i]) || 
+		(*x.field[k])[i] == '_'))
+		fprintf(f, "%c", (*x.field[k])[i++]);
 	    fprintf(f, "</B> - ");
 
-	    while(i < entry->field[k]->length())
-		fprintf(f, "%c", (*entry->field[k])[i++]);
+	    while(i < x.field[k]->length())
+		fprintf(f, "%c", (*x.field[k])[i++]);
 	    fprintf(f, "<BR>");
 	    }
 	}
 
-    writeHTMLList(f, entry->retrn, _("Returns"));
-    writeHTMLList(f, entry->precondition, _("Preconditions"));
-    writeHTMLList(f, entry->postcondition, _("Postconditions"));
-    writeHTMLList(f, entry->friends, _("Friends"));
+    writeHTMLList(f, x.retrn, _("Returns"));
+    writeHTMLList(f, x.precondition, _("Preconditions"));
+    writeHTMLList(f, x.postcondition, _("Postconditions"));
+    writeHTMLList(f, x.friends, _("Friends"));
 
-    if(entry->author.length())
-	fprintf(f, _("<DT><B>Author:</B><DD>%s\n"), entry->author.c_str());
+    if(x.author.length())
+	fprintf(f, _("<DT><B>Author:</B><DD>%s\n"), x.author.c_str());
 
-    if(entry->version.length())
-	fprintf(f, _("<DT><B>Version:</B><DD>%s\n"), entry->version.c_str());
+    if(x.version.length())
+	fprintf(f, _("<DT><B>Version:</B><DD>%s\n"), x.version.c_str());
 
-    if(entry->deprecated.length())
-	fprintf(f, _("<DT><B><I>Deprecated:</I></B><DD>%s\n"), entry->deprecated.c_str());
+    if(x.deprecated.length())
+	fprintf(f, _("<DT><B><I>Deprecated:</I></B><DD>%s\n"), x.deprecated.c_str());
 
-    if(entry->since.length())
-	fprintf(f, _("<DT><B>Since:</B><DD>%s\n"), entry->since.c_str());
+    if(x.since.length())
+	fprintf(f, _("<DT><B>Since:</B><DD>%s\n"), x.since.c_str());
 
-    if(entry->see.size())
+    if(x.see.size())
 	{
 	fprintf(f, _("<DT><B>See Also:</B><DD>"));
-	for(k = 0; k < entry->see.size(); k++)
-	    if(entry->see[k]->length())
-		fprintf(f, "%s<BR>", seeToHtml(*entry->see[k], entry));
+	for(k = 0; k < x.see.size(); k++)
+	    if(x.see[k]->length())
+		fprintf(f, "%s<BR>", seeToHtml(*x.see[k], entry));
 	}
 
     fprintf(f, "<DD></DL><P>");
@@ -1365,8 +1476,9 @@ void writeDoc(FILE *f, Entry *entry)
     if(entry->ownPage)
 	return;
     int toBeDocumented = subEntryIsToBeDocumented(entry);
-    Entry *tmp;
+    int i;
 
+    needHtml(entry);
     if(toBeDocumented)
 	{
 	char *args = (entry->hargs);
@@ -1389,11 +1501,11 @@ void writeDoc(FILE *f, Entry *entry)
 	writeTags(f, entry);
 	}
 
-    if(entry->sub)
+    if(entry->subEntries.size())
 	{
 	fprintf(f, "<DL>\n");
-	for(tmp = entry->sub; tmp; tmp = tmp->next)
-	    writeDoc(f, tmp);
+	for(i = 0; i < entry->subEntries.size(); i++)
+	    writeDoc(f, entry->subEntries[i]);
 	fprintf(f, "</DL>\n");
 	}
 }
@@ -1456,6 +1568,7 @@ void writeHeader(Entry *e, FILE *f)
     int blank_len, arg_len;
     char *args, *arg;
 
+    needHtml(e);
     if(header.length() == 0 && ownHeader.length() == 0)
 	{
 	fprintf(f, "%s", docType);
@@ -1564,8 +1677,9 @@ void writeHeader(Entry *e, FILE *f)
 
 void writeManPage(Entry *e, FILE *f)
 {
+    const EntryExtra& x = e->constExtra();
     int i, numChilds, numParents = 0;
-    Entry *c, *tmp;
+    Entry *c;
     McString buf;
     MemberList list;
     MemberWriter memberWriter;
@@ -1590,25 +1704,25 @@ void writeManPage(Entry *e, FILE *f)
     if(e->isClass())            // is it really a class?
 	{ 
 	// the inheritance
-	numChilds = e->pubChilds.size() + e->proChilds.size() + e->priChilds.size();
+	numChilds = x.pubChilds.size() + x.proChilds.size() + x.priChilds.size();
 	if(language == LANG_JAVA)
-	    numParents = e->pubBaseclasses.size()+ e->proBaseclasses.size() +
-		e->otherPubBaseclasses.size() + e->otherProBaseclasses.size();
+	    numParents = x.pubBaseclasses.size()+ x.proBaseclasses.size() +
+		x.otherPubBaseclasses.size() + x.otherProBaseclasses.size();
 	else
-	    numParents = e->pubBaseclasses.size() + e->priBaseclasses.size() +
-		e->proBaseclasses.size() + e->otherPubBaseclasses.size() +
-		e->otherPriBaseclasses.size() + e->otherProBaseclasses.size();
+	    numParents = x.pubBaseclasses.size() + x.priBaseclasses.size() +
+		x.proBaseclasses.size() + x.otherPubBaseclasses.size() +
+		x.otherPriBaseclasses.size() + x.otherProBaseclasses.size();
 
 	if(numParents > 0 || numChilds > 0 || trivialGraphs)
 	    {
 	    fprintf(f, _("<HR>\n\n<H2>Inheritance:</H2>\n"));
 	    ClassGraphWriter::write(f, e);
-	    if(language == LANG_JAVA && e->implements.size() > 0)
+	    if(language == LANG_JAVA && x.implements.size() > 0)
 		ClassGraphWriter::writeImplements(f, e);
 	    }
 
 	// the members 
-	if(e->sub)
+	if(e->subEntries.size())
 	    {
 	    fprintf(f, "<HR>\n\n");
 	    showMembers(e, f, 1, &list);
@@ -1616,12 +1730,12 @@ void writeManPage(Entry *e, FILE *f)
 	}
     else                       // this is not a class
 	{ 
-	if(e->sub)
+	if(e->subEntries.size())
 	    {
 	    fprintf(f, "\n<HR>\n");
 	    memberWriter.startList(f, " ", true);
-	    for(tmp = e->sub; tmp; tmp = tmp->next)
-		memberWriter.addMember(tmp, true, false);
+	    for(i = 0; i < e->subEntries.size(); i++)
+		memberWriter.addMember(e->subEntries[i], true, false);
 	    }
 	memberWriter.endList();
 	}
@@ -1629,12 +1743,12 @@ void writeManPage(Entry *e, FILE *f)
     // the inherited members
     if(e->isClass())            // is it really a class?
 	if(showInherited)
-	    for(i = 0; i < e->baseclasses.size(); i++)
+	    for(i = 0; i < x.baseclasses.size(); i++)
 		{
 		fprintf(f, _("<HR><H3>Inherited from <A HREF=\"%s\">%s</A>:</H3>\n"),
-		    (e->baseclasses)[i]->fileName.c_str(),
-		    (e->baseclasses)[i]->hname);
-		writeInherited((e->baseclasses)[i], f, &list);
+		    (x.baseclasses)[i]->fileName.c_str(),
+		    (x.baseclasses)[i]->hname);
+		writeInherited((x.baseclasses)[i], f, &list);
 		}
 
     if(!printClassDocBeforeGroup)
@@ -1645,28 +1759,28 @@ void writeManPage(Entry *e, FILE *f)
 	htmlComment (f, e, (DOC | MEMO));
 	}
 
-    if(e->sub)
+    if(e->subEntries.size())
 	{
 	fprintf(f, "<DL>\n");
-	for(tmp = e->sub; tmp; tmp = tmp->next)
-	    writeDoc(f, tmp);
+	for(i = 0; i < e->subEntries.size(); i++)
+	    writeDoc(f, e->subEntries[i]);
 	fprintf(f, "</DL>\n");
 	}
 
     // the childrens
     if(e->isClass())            // is it really a class?
-	if(e->pubChilds.size() || e->proChilds.size())
+	if(x.pubChilds.size() || x.proChilds.size())
 	    {
 	    fprintf(f, _("<HR>\n<DL><DT><B>Direct child classes:\n</B><DD>"));
 	    c = e;
-	    for(i = 0; i < c->pubChilds.size(); i++)
+	    for(i = 0; i < c->constExtra().pubChilds.size(); i++)
 		fprintf(f, "<A HREF=\"%s\">%s</A><BR>\n",
-		    c->pubChilds[i]->fileName.c_str(),
-		    c->pubChilds[i]->hname);
-	    for(i = 0; i < c->proChilds.size(); i++)
+		    c->constExtra().pubChilds[i]->fileName.c_str(),
+		    c->constExtra().pubChilds[i]->hname);
+	    for(i = 0; i < c->constExtra().proChilds.size(); i++)
 		fprintf(f, "<A HREF=\"%s\">%s</A><BR>\n",
-		    c->proChilds[i]->fileName.c_str(),
-		    c->proChilds[i]->hname);
+		    c->constExtra().proChilds[i]->fileName.c_str(),
+		    c->constExtra().proChilds[i]->hname);
 	    fprintf(f, "</DL>\n\n");
 	    }
 	else
@@ -1701,22 +1815,31 @@ static FILE *myOpen(const char *dir, const McString& name)
     return f;
 }
 
-void makeHtmlNames(Entry *entry)
+// Closes a file opened by myOpen(), counting the bytes written
+static void myClose(FILE *f)
+{
+    docStats.files++;
+    docStats.fileBytes += ftell(f);
+    fclose(f);
+    releaseHtml();
+}
+
+void htmlStats()
+{
+    statsTable("page names", files.size(), files.buckets());
+}
+
+// This converts the name of an entry
+static void makeHtmlName(Entry *entry)
 {
-    Entry *tmp;
     entry->hname = strToHtml(entry->name, 0, entry, false);
     if(entry->section == EMPTY_SEC)
 	entry->section = PACKAGE_SEC;
-
-    if(entry->sub)
-	for(tmp = entry->sub; tmp; tmp = tmp->next)
-	    makeHtmlNames(tmp);
 }
 
-// This creates names for all those with their own pages
-void makeFileNames(Entry *entry)
+// This creates the name of the page of an entry that has one
+static void makePageFileName(Entry *entry)
 {
-    Entry *tmp;
     McString file;
 
     if(entry->ownPage)
@@ -1753,13 +1876,10 @@ void makeFileNames(Entry *entry)
 	    }
 	entry->fileName = makeFileName(file, entry);
 	}
-    if(entry->sub)
-	for(tmp = entry->sub; tmp; tmp = tmp->next)
-	    makeFileNames(tmp);
 }
 
-// This creates filenames for items from their parents
-void inheritFileNames(Entry *entry)
+// This creates the filename of an item from its parents
+static void inheritFileName(Entry *entry)
 {
     Entry *tmp;
 
@@ -1779,21 +1899,19 @@ void inheritFileNames(Entry *entry)
 #endif
 	    }
 	}
-
-    if(entry->sub)
-	for(tmp = entry->sub; tmp; tmp = tmp->next)
-	    inheritFileNames(tmp);
 }
 
 // This marks those names that can't be attached to a class
 // It also junks redundant floating comments as a bad job...
 void relocateNames(Entry *root)
 {
-    Entry *e, *next;
-    e = root->sub;
-    while(e)
+    Entry *e;
+    int i;
+
+    // backwards, so that removing an entry does not move those still to come
+    for(i = root->subEntries.size() - 1; i >= 0; i--)
 	{
-	next = e->next;
+	e = root->subEntries[i];
 	if(!e->ownPage)
 	    if(useGeneral)
 		{
@@ -1810,73 +1928,180 @@ void relocateNames(Entry *root)
 		if(!fastNotSmall)
 		    delete(e);
 		}
-	e = next;
 	}	
 }
 
-// Decide what entries should have their's own page
-void decideAboutOwnPages(Entry *entry)
+// Decide whether an entry should have its own page
+static void decideAboutOwnPage(Entry *entry)
 {
-    Entry *tmp;
-
     if(entry->section == EMPTY_SEC)
 	entry->section = MANUAL_SEC;
 
     // The Quantel extension bit is to stop annoying stuff like the RCS info
     // (often in a FED fold) from turning up in the data...
-    if(entry->sub || (entry->doc.length() > 1 && !QuantelExtn) || entry->isClass())
+    if(entry->subEntries.size() || (entry->doc.length() > 1 && !QuantelExtn) ||
+	entry->isClass())
 	entry->ownPage = true;
+}
+
+/* Gives #entry# and all entries below it their pages, file names and HTML
+   names in one walk. A file name depends only on the entry and the entries
+   above it, so one walk in preorder gives the names the separate walks over
+   the tree gave. #decide# is false where no entries get pages of their own:
+   below entries that are not groups, packages, namespaces or classes, and
+   for the members of classes that are not classes themselves.
+
+   Entries under the root that get no page are left for #relocateNames()#.
+*/
+static void prepareHtml(Entry *entry, bool decide)
+{
+    Entry *tmp;
+    int i;
 
-    if(entry->sub && (entry->section == MANUAL_SEC ||
+    if(decide)
+	decideAboutOwnPage(entry);
+    makePageFileName(entry);
+
+    if(entry->parent == 0)
+	{
+	// This is as items under root with no page inherit this name
+	entry->fileName = GENERAL_NAME;
+	entry->fileName += htmlSuffix;
+	}
+    else
+	if(entry->parent->parent == 0)
+	    {
+	    tmp = entry->parent;
+	    if((tmp->name.length() == 0 || tmp->section != MANUAL_SEC) &&
+		tmp->subEntries.size() == 1 && entry->section == MANUAL_SEC)
+		{
+		entry->fileName = "index";
+		entry->fileName += htmlSuffix;
+		haveManualRootSec = true;
+		}
+	    if(!entry->ownPage && !useGeneral)
+		return;
+	    }
+
+    inheritFileName(entry);
+
+    // before makeHtmlName() turns empty sections into packages
+    decide = decide && (entry->section == MANUAL_SEC ||
 	entry->section == PACKAGE_SEC ||
-	entry->section == NAMESPACE_SEC || (entry->section & CLASS_SEC)))
-	for(tmp = entry->sub; tmp; tmp = tmp->next)
-	    if(!(entry->section & CLASS_SEC) || ((entry->section & CLASS_SEC) &&
-		(tmp->section & CLASS_SEC)))
-		decideAboutOwnPages(tmp);
+	entry->section == NAMESPACE_SEC || (entry->section & CLASS_SEC));
+    makeHtmlName(entry);
+
+    for(i = 0; i < entry->subEntries.size(); i++)
+	{
+	tmp = entry->subEntries[i];
+	prepareHtml(tmp, decide && (!(entry->section & CLASS_SEC) ||
+	    (tmp->section & CLASS_SEC)));
+	}
 }
 
-void makeHtml(Entry *entry)
+// Replaces a tag by its HTML form
+static void tagToHtml(McString& tag, Entry *entry, bool withLinks)
+{
+    char *html = strToHtml(tag, 0, entry, withLinks);
+
+    tag = html;
+    freeHtml(html);
+}
+
+static void tagsToHtml(McDArray<McString*>& tags, Entry *entry,
+    bool withLinks)
 {
-    Entry *tmp;
     int i;
 
+    for(i = 0; i < tags.size(); i++)
+	tagToHtml(*tags[i], entry, withLinks);
+}
+
+/* Entries whose HTML strings have been made for the page being written,
+   with #--streaming# only.
+*/
+static McDArray<Entry*> converted;
+
+/* Makes the HTML strings of an entry, unless this has been done already.
+   Without #--streaming#, #makeHtml()# does so for all entries before the
+   first page is written. With it, the writers call this for each entry
+   they show and #releaseHtml()# frees the strings when the page is done.
+   The tags are converted in place, once.
+*/
+static void needHtml(Entry *entry)
+{
+    double start;
+    long bytes;
+
+    if(entry->hmemo)
+	return;
+    start = fileReport ? statsClock() : 0;
+    bytes = docStats.htmlBytes;
+
     entry->hmemo = strToHtml(entry->memo, 0, entry, false);
     entry->hdoc = strToHtml(entry->doc, 0, entry, false);
     entry->hargs = strToHtml(entry->args, 0, entry, true, true);
     entry->htype = strToHtml(entry->type, 0, entry, true, true);
-    entry->author = strToHtml(entry->author, 0, entry, false);
-    entry->version = strToHtml(entry->version, 0, entry, false);
-    entry->deprecated = strToHtml(entry->deprecated, 0, entry, false);
-    entry->since = strToHtml(entry->since, 0, entry, false);
-
-    for(i = 0; i < entry->retrn.size(); i++)
-	*entry->retrn[i] = strToHtml(*entry->retrn[i], 0, entry, false);
-
-    for(i = 0; i < entry->param.size(); i++)
-	*entry->param[i] = strToHtml(*entry->param[i], 0, entry, true);
-
-    for(i = 0; i < entry->field.size(); i++)
-	*entry->field[i] = strToHtml(*entry->field[i], 0, entry, false);
+    if(entry->hasExtra() && !entry->constExtra().inHtml)
+	{
+	EntryExtra& x = entry->extra();
+
+	tagToHtml(x.author, entry, false);
+	tagToHtml(x.version, entry, false);
+	tagToHtml(x.deprecated, entry, false);
+	tagToHtml(x.since, entry, false);
+	tagsToHtml(x.retrn, entry, false);
+	tagsToHtml(x.param, entry, true);
+	tagsToHtml(x.field, entry, false);
+	tagsToHtml(x.exception, entry, false);
+	tagsToHtml(x.invariant, entry, false);
+	tagsToHtml(x.precondition, entry, false);
+	tagsToHtml(x.postcondition, entry, false);
+	tagsToHtml(x.friends, entry, true);
+	x.inHtml = true;
+	}
 
-    for(i = 0; i < entry->exception.size(); i++)
-	*entry->exception[i] = strToHtml(*entry->exception[i], 0, entry, false);
+    if(fileReport && entry->file.length() > 0)
+	{
+	FileCost *c = fileCost(entry->file.c_str());
+	c->html += statsClock() - start;
+	c->htmlBytes += docStats.htmlBytes - bytes;
+	}
 
-    for(i = 0; i < entry->invariant.size(); i++)
-	*entry->invariant[i] = strToHtml(*entry->invariant[i], 0, entry, false);
+    if(streamHtml)
+	converted.append(entry);
+}
 
-    for(i = 0; i < entry->precondition.size(); i++)
-	*entry->precondition[i] = strToHtml(*entry->precondition[i], 0, entry, false);
+// Frees the HTML strings made since the last call (#--streaming#)
+static void releaseHtml()
+{
+    Entry *e;
+    int i;
 
-    for(i = 0; i < entry->postcondition.size(); i++)
-	*entry->postcondition[i] = strToHtml(*entry->postcondition[i], 0, entry, false);
+    for(i = 0; i < converted.size(); i++)
+	{
+	e = converted[i];
+	freeHtml(e->hmemo);
+	freeHtml(e->hdoc);
+	freeHtml(e->hargs);
+	freeHtml(e->htype);
+	e->hmemo = e->hdoc = e->hargs = e->htype = 0;
+	}
+    converted.clear();
+}
 
-    for(i = 0; i < entry->friends.size(); i++)
-	*entry->friends[i] = strToHtml(*entry->friends[i], 0, entry, true);
+void makeHtml(Entry *entry)
+{
+    int i;
 
-    if(entry->sub)
-	for(tmp = entry->sub; tmp; tmp = tmp->next)
-	    makeHtml(tmp);
+    needHtml(entry);
+    if(entry->subEntries.size())
+	{
+	traceBegin("html", entry->name.c_str());
+	for(i = 0; i < entry->subEntries.size(); i++)
+	    makeHtml(entry->subEntries[i]);
+	traceEnd();
+	}
 }
 
 void writePageSub(FILE *f, Entry *e)
@@ -1889,6 +2114,7 @@ void writePageSub(FILE *f, Entry *e)
 	    e->fullName.c_str(), e->args.c_str(), e->fileName.c_str());
 #endif
 
+    needHtml(e);
     if(withTables)
 	fprintf(f, "<TR><TD VALIGN=TOP>");
     else
@@ -1938,6 +2164,7 @@ void writeManPageRec(const char *dir, Entry *e)
     Entry *tmp;
     McString buf;
     FILE *f;
+    int i;
 
 #ifdef DEBUG
     if(verb)
@@ -1965,6 +2192,7 @@ void writeManPageRec(const char *dir, Entry *e)
 	    fprintf(stderr, _("Cannot open `%s' for writing\n"), e->fileName.c_str());
 	    return;
 	    }
+	traceBegin("page", e->fileName.c_str());
 	if(e->section != MANUAL_SEC && e->section != PACKAGE_SEC)
 	    writeManPage(e, f);
 	else
@@ -1977,14 +2205,14 @@ void writeManPageRec(const char *dir, Entry *e)
 		htmlComment(f, e, (DOC | MEMO));
 		}
 
-	    if(e->sub)
+	    if(e->subEntries.size())
 		{
 		if(withTables)
 		    fprintf(f, "\n<TABLE>\n");
 		else
 		    fprintf(f, "\n<HR>\n<DL>\n");
-		for(tmp = e->sub; tmp; tmp = tmp->next)
-		    writePageSub(f, tmp);
+		for(i = 0; i < e->subEntries.size(); i++)
+		    writePageSub(f, e->subEntries[i]);
 		if(withTables)
 		    fprintf(f, "\n</TABLE>\n");
 		else
@@ -2002,21 +2230,25 @@ void writeManPageRec(const char *dir, Entry *e)
 	    fprintf(f, "%s", buf.c_str());
 	    copyright(f);
 	    }
-	fclose(f);
+	myClose(f);
+	traceEnd();
 	}
-    if(e->sub && (e->section == MANUAL_SEC || e->section == PACKAGE_SEC ||
-	e->section == NAMESPACE_SEC || (e->section & CLASS_SEC)))
-	for(tmp = e->sub; tmp; tmp = tmp->next)
+    if(e->section == MANUAL_SEC || e->section == PACKAGE_SEC ||
+	e->section == NAMESPACE_SEC || (e->section & CLASS_SEC))
+	for(i = 0; i < e->subEntries.size(); i++)
+	    {
+	    tmp = e->subEntries[i];
 	    if(!(e->section & CLASS_SEC) || ((e->section & CLASS_SEC) &&
 		(tmp->section & CLASS_SEC)))
 		writeManPageRec(dir, tmp);
+	    }
 }
 
 static void dumpFile(const char *dir, const char *name, const unsigned char *data, int size)
 {
     FILE *f = myOpen(dir, name);
     fwrite(data, 1, size, f);
-    fclose(f);
+    myClose(f);
 }
 
 void readTemplates()
@@ -2071,11 +2303,10 @@ void readTemplates()
 void doHTML(const char *dir, Entry *root)
 {
     FILE *f;
-    Entry *tmp;
     McString buf;
     int c;
-    bool haveManualRootSec = false;
 
+    haveClassGraphs = !noClassGraph && relevantClassGraphs(root);
     buildHeaders();
     buildFooters();
 
@@ -2092,21 +2323,8 @@ void doHTML(const char *dir, Entry *root)
 	else
 	    fprintf(stderr, _("Could not create `%s' directory\n"), dir);
 
-    decideAboutOwnPages(root);
-    makeFileNames(root);
-
-    if(root->name.length() == 0 || root->section != MANUAL_SEC)
-	if(root->sublist.size() == 1 && root->sublist[0]->section == MANUAL_SEC)
-	    {
-	    root->sublist[0]->fileName = "index";
-	    root->sublist[0]->fileName += htmlSuffix;
-	    haveManualRootSec = true;
-	    }
-
-    // This is as items under root with no page inherit this name
-    root->fileName = GENERAL_NAME;
-    root->fileName += htmlSuffix;
-    inheritFileNames(root);
+    beginPhase("prepare pages");
+    prepareHtml(root, true);
     relocateNames(root);
 
     if(root->name.length() > 0 && root->section == MANUAL_SEC)
@@ -2120,15 +2338,18 @@ void doHTML(const char *dir, Entry *root)
 	root->dump(stdout, true);
 #endif
 
-    if(verb)
-	printf(_("Converting DOC++ to HTML...\n"));
+    endPhase();
 
-    if(root->section == EMPTY_SEC)
-	root->section = MANUAL_SEC;
-    for(tmp = root; tmp; tmp = tmp->next)
-	makeHtmlNames(tmp);
-    for(tmp = root; tmp; tmp = tmp->next)	// This takes the bulk of the time
-	makeHtml(tmp);
+    // With --streaming, the pages convert what they show as they are written
+    if(!streamHtml)
+	{
+	if(verb)
+	    printf(_("Converting DOC++ to HTML...\n"));
+
+	beginPhase("convert to HTML");
+	makeHtml(root);			// This takes the bulk of the time
+	endPhase();
+	}
 
     readTemplates();
 
@@ -2163,10 +2384,12 @@ void doHTML(const char *dir, Entry *root)
     if(verb)
 	printf(_("Writing files...\n"));
 
+    beginPhase("write pages");
+
     dumpFile(dir, "icon1.gif", blueBall, sizeof(blueBall));
     dumpFile(dir, "icon2.gif", greyBall, sizeof(greyBall));
 
-    if(javaGraphs && !noClassGraph && relevantClassGraphs(root))
+    if(javaGraphs && haveClassGraphs)
 	{
 	dumpFile(dir, "ClassGraph.class", ClassGraph_class,
 	    sizeof(ClassGraph_class));
@@ -2189,9 +2412,9 @@ void doHTML(const char *dir, Entry *root)
     buf += htmlSuffix;
     f = myOpen(dir, buf);
     writeTOC(f);
-    fclose(f);
+    myClose(f);
 
-    if(!noClassGraph && relevantClassGraphs(root))
+    if(haveClassGraphs)
 	// Class heirarchy
 	{
 	if(verb)
@@ -2201,7 +2424,7 @@ void doHTML(const char *dir, Entry *root)
 	buf += htmlSuffix;
 	f = myOpen(dir, buf);
 	writeHIER(f);
-	fclose(f);
+	myClose(f);
 
 	// Java class heirarchy
 	if(javaGraphs)
@@ -2210,7 +2433,7 @@ void doHTML(const char *dir, Entry *root)
 	    buf += htmlSuffix;
 	    f = myOpen(dir, buf);
 	    writeHIERjava(f);
-	    fclose(f);  
+	    myClose(f);
 	    }
 	}
 
@@ -2245,5 +2468,6 @@ void doHTML(const char *dir, Entry *root)
     fprintf(generalf, "%s", pageFooter.c_str());
     copyright(generalf);
 
-    fclose(generalf);
+    myClose(generalf);
+    endPhase();
 }      
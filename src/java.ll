@@ -30,6 +30,8 @@
 #include <stdio.h>
 
 #include "doc.h"
+#include "stats.h"
+#include "yyread.h"
 
 static const char	*inputString;
 static int		inputPosition;
@@ -68,15 +70,7 @@ static void lineCount()
 
 static int yyread(char *buf, int max_size)
 {
-    int c = 0;
-
-    while(c < max_size && inputString[inputPosition])
-	{
-	*buf = inputString[inputPosition++];
-	c++;
-	buf++;
-	}
-    return c;
+    return yyReadString(buf, max_size, inputString, inputPosition);
 }
 
 %}
@@ -124,6 +118,7 @@ static int yyread(char *buf, int max_size)
 					for(i = 0; yytext[i + 1] != 6; i++)
 					    yyFileName[i] = yytext[i + 1];
 					yyFileName[i] = 0;
+					costParse(yyFileName);
 					current_root  = global_root;
 					}
 
@@ -168,11 +163,11 @@ static int yyread(char *buf, int max_size)
 					}
 
 <Package>[a-z_A-Z0-9]*			{
-					Entry *find = current_root->sub;
-					for(; find; find = find->next)
-					    if(find->section == PACKAGE_SEC)
-						if(find->name == (const char*)yytext)
-						    break;
+					Entry *find = 0;
+					for(int i = 0; i < current_root->subEntries.size() && !find; i++)
+					    if(current_root->subEntries[i]->section == PACKAGE_SEC)
+						if(current_root->subEntries[i]->name == (const char*)yytext)
+						    find = current_root->subEntries[i];
 					if(find == 0)
 					    {
 					    find = new Entry;
@@ -193,7 +188,7 @@ static int yyread(char *buf, int max_size)
 					}
 
 <Import>[a-z_A-Z0-9.*]*			{
-					current->import.append(new McString(yytext));
+					current->extra().import.append(new McString(yytext));
 					}
 
 <Import>;				{
@@ -220,12 +215,12 @@ static int yyread(char *buf, int max_size)
 					}
 
 <Extends>[a-z_A-Z.0-9]+			{
-					current->extends.append(new McString(yytext));
+					current->extra().extends.append(new McString(yytext));
 					BEGIN(ClassName);
 					}
 
 <Implements>[a-z_A-Z.0-9]+		{
-					current->implements.append(new McString(yytext));
+					current->extra().implements.append(new McString(yytext));
 					BEGIN(ClassName);
 					}
 
@@ -235,7 +230,7 @@ static int yyread(char *buf, int max_size)
                                         tmp->remove(tmp->length() - 1);
                                         while(!isalpha(tmp->last()))
 					    tmp->remove(tmp->length() - 1);
-					current->implements.append(tmp);
+					current->extra().implements.append(tmp);
 					BEGIN(Implements);
 					}
 
@@ -260,8 +255,8 @@ static int yyread(char *buf, int max_size)
 					else
 					    {
 					    if(current->section == CLASS_SEC &&
-						!current->extends.size())
-						    current->extends.append(new McString("java.lang.Object"));
+						!current->extra().extends.size())
+						    current->extra().extends.append(new McString("java.lang.Object"));
 					    current_root->addSubEntry(current);
 					    current = new Entry;
 					    if(findClasses)
@@ -614,8 +609,10 @@ void parseJavaClasses(Entry *rt)
 {
     if(rt == 0)
 	return;
-    for(Entry *cr = rt->sub; cr; cr = cr->next)
+    for(int i = 0; i < rt->subEntries.size(); i++)
 	{
+	Entry *cr = rt->subEntries[i];
+
 	if(cr->program.length())
 	    {
 	    inputString = cr->program.c_str();
@@ -629,7 +626,9 @@ void parseJavaClasses(Entry *rt)
 	    current_root = cr;
 	    strcpy(yyFileName, cr->file.c_str());
 	    yyLineNr = cr->startLine;
+	    costParse(yyFileName);
 	    javaYYlex();
+	    costParse(0);
 	    cr->program.clear();
 	    }
 	parseJavaClasses(cr);
@@ -654,6 +653,7 @@ void parseJava(Entry *rt)
     findClasses = true;
 
     javaYYlex();
+    costParse(0);
     rt->program.clear();
 
     parseJavaClasses(rt);
@@ -29,11 +29,15 @@
 #include <getopt.h>
 #include <locale.h>
 #include <stdio.h>
+#include <string.h>
 
+#include "McAlloc.h"
 #include "McDirectory.h"
 #include "McString.h"
 #include "doc.h"
+#include "docdb.h"
 #include "nametable.h"
+#include "stats.h"
 #include "tex2gif.h"
 
 #define	GIF_FILE_NAME	"gifs.db"
@@ -42,6 +46,7 @@ FILE *out;
 char language;
 Entry *root;
 NameTable gifs;
+NameTableFile gifsFile;
 
 extern void doHTML(const char *dir, Entry *root);
 
@@ -69,6 +74,18 @@ void help()
     printf(_("  -v  --verbose          turn verbose mode on\n"));
     printf(_("  -V  --version          output version information and exit\n"));
     printf(_("  -y  --scan-includes    scan `#include'ed header files\n"));
+    printf(_("      --exclude PATTERN  skip files and directories matching PATTERN\n"));
+    printf(_("      --file-report      print the costs of each input file when done\n"));
+    printf(_("      --include PATTERN  read files matching PATTERN from directories\n"));
+    printf(_("      --input0 FILE      read a list of input files ending with NUL from FILE\n"));
+    printf(_("      --mem-report       print the memory used per subsystem when done\n"));
+    printf(_("      --query DB QUERY NAME\n"
+	     "                         look up NAME in the database DB and exit, QUERY\n"
+	     "                         is name, show, file, members, bases or subclasses\n"));
+    printf(_("      --stats            print timings and counters when done\n"));
+    printf(_("      --stats-json FILE  write timings and counters to FILE as JSON\n"));
+    printf(_("      --streaming        convert to HTML page by page to save memory\n"));
+    printf(_("      --trace FILE       write a Chrome trace of the run to FILE\n"));
     printf(_("  -Y  --idl              parse IDL instead of C/C++\n"));
     printf(_("  -z  --php              parse PHP instead of C/C++\n\n"));
 
@@ -76,6 +93,7 @@ void help()
     printf(_("  -t  --tex              TeX output output\n"));
     printf(_("  -Z  --docbook          DocBook SGML output\n"));
     printf(_("  -L  --docbookxml       DocBook XML output\n"));
+    printf(_("      --db FILE          documentation database for --query\n"));
 
     printf(_("Additional options for HTML output:\n"));
     printf(_("  -a  --tables           use tables instead of description lists\n"));
@@ -91,6 +109,7 @@ void help()
     printf(_("  -k  --trivial-graphs   keep trivial class graphs\n"));
     printf(_("  -K  --stylesheet FILE  use FILE as HTML style sheet\n"));
     printf(_("  -m  --no-members       don't show all members in DOC section\n"));
+    printf(_("      --mathml           use MathML instead of GIFs for simple formulas\n"));
     printf(_("  -M  --full-toc         show members in TOC\n"));
     printf(_("  -P  --no-general       discard general stuff\n"));
     printf(_("  -S  --sort             sort entries alphabetically\n"));
@@ -133,9 +152,82 @@ void unknownOption(char c1, char c2 = 0)
 	fprintf(stderr, _("Unknown option `-%c%c'. Try `doc++ --help'\n"), c1, c2);
 }
 
+// adds #name# to #list#, see #readFileList()#
+static void addListedName(McDArray<McString *>& list, McString *name,
+    char separator)
+{
+    if(separator == '\n' && name->length() && name->last() == '\r')
+	name->remove(name->length() - 1);
+    if(name->length())
+	list.append(name);
+    else
+	delete name;
+}
+
+/* Appends the names in the file list #file#, or the standard input if it
+   is `-', to #list#. The names end with #separator# and may be of any
+   length. Lines may also end with `\r\n', empty names are skipped.
+*/
+static bool readFileList(const McString& file, char separator,
+    McDArray<McString *>& list)
+{
+    FILE *f = (file == "-") ? stdin : fopen(file.c_str(), "rb");
+    char buf[16384];
+    McString part;		// of a name read with the block before
+    size_t n;
+
+    if(!f)
+	return false;
+    while((n = fread(buf, 1, sizeof(buf), f)) > 0)
+	{
+	const char *p = buf;
+	const char *end = buf + n;
+	const char *q;
+
+	while((q = (const char *)memchr(p, separator, end - p)))
+	    {
+	    McString *name = new McString(p, 0, q - p);
+	    if(part.length())
+		{
+		part += *name;
+		*name = part;
+		part.clear();
+		}
+	    addListedName(list, name, separator);
+	    p = q + 1;
+	    }
+	part += McString(p, 0, end - p);
+	}
+    // the last name need not be followed by a separator
+    addListedName(list, new McString(part), separator);
+    if(f != stdin)
+	fclose(f);
+    return true;
+}
+
+// codes of the options without a short form
+enum
+{
+    OPT_MATHML = 256,
+    OPT_STATS,
+    OPT_STATS_JSON,
+    OPT_TRACE,
+    OPT_FILE_REPORT,
+    OPT_MEM_REPORT,
+    OPT_STREAMING,
+    OPT_INCLUDE,
+    OPT_EXCLUDE,
+    OPT_INPUT0,
+    OPT_DB,
+    OPT_QUERY
+};
+
 int main(int argc, char **argv)
 {
     int i, c, depth, gifNum = 0;
+    bool showStats = false;		// --stats
+    McString statsFile;			// --stats-json FILE
+    bool memReport = false;		// --mem-report
 
     setlocale(LC_ALL, "");
 #ifdef ENABLE_NLS
@@ -143,9 +235,15 @@ int main(int argc, char **argv)
     textdomain(PACKAGE);
 #endif
 
+    // count from the first allocation on
+    for(i = 1; i < argc; i++)
+	if(strcmp(argv[i], "--mem-report") == 0)
+	    mcAllocAccounting = true;
+
     root = new Entry;
     root->docify = true;
     McString& inputFile = root->program;
+    inputFile.setTag(MC_TAG_SCANNER);
 
     out = stdout;
     language = LANG_CXX;
@@ -189,6 +287,18 @@ int main(int argc, char **argv)
         { "no-java-graphs", no_argument, 0, 'j' },
         { "no-members", no_argument, 0, 'm' },
         { "full-toc", no_argument, 0, 'M' },
+        { "mathml", no_argument, 0, OPT_MATHML },
+        { "stats", no_argument, 0, OPT_STATS },
+        { "stats-json", required_argument, 0, OPT_STATS_JSON },
+        { "trace", required_argument, 0, OPT_TRACE },
+        { "file-report", no_argument, 0, OPT_FILE_REPORT },
+        { "mem-report", no_argument, 0, OPT_MEM_REPORT },
+        { "streaming", no_argument, 0, OPT_STREAMING },
+        { "include", required_argument, 0, OPT_INCLUDE },
+        { "exclude", required_argument, 0, OPT_EXCLUDE },
+        { "input0", required_argument, 0, OPT_INPUT0 },
+        { "db", required_argument, 0, OPT_DB },
+        { "query", required_argument, 0, OPT_QUERY },
         { "no-general", no_argument, 0, 'P' },
         { "sort", no_argument, 0, 'S' },
         { "header", required_argument, 0, 'T' },
@@ -239,12 +349,14 @@ int main(int argc, char **argv)
 		HTMLsyntax = true;
 		break;
 	    case 'I':
-		if(optarg[0] == '-')
+		// `-' is the standard input
+		if(optarg[0] == '-' && optarg[1])
 		    {
 		    missingArg("--input");
 		    break;
 		    }
 		fileList = optarg;
+		fileListNul = false;
 		break;
 	    case 'J':
 		java = true;
@@ -350,6 +462,49 @@ int main(int argc, char **argv)
 	    case 'G':
     		forceGifs = true;
 		break;
+	    case OPT_MATHML:
+		useMathML = true;
+		break;
+	    case OPT_STATS:
+		showStats = true;
+		break;
+	    case OPT_STATS_JSON:
+		statsFile = optarg;
+		break;
+	    case OPT_FILE_REPORT:
+		fileReport = true;
+		break;
+	    case OPT_MEM_REPORT:
+		memReport = mcAllocAccounting = true;
+		break;
+	    case OPT_STREAMING:
+		streamHtml = true;
+		break;
+	    case OPT_INCLUDE:
+		includeFiles.append(new McString(optarg));
+		break;
+	    case OPT_EXCLUDE:
+		excludeFiles.append(new McString(optarg));
+		break;
+	    case OPT_INPUT0:
+		if(optarg[0] == '-' && optarg[1])
+		    {
+		    missingArg("--input0");
+		    break;
+		    }
+		fileList = optarg;
+		fileListNul = true;
+		break;
+	    case OPT_DB:
+		dbFile = optarg;
+		break;
+	    case OPT_QUERY:
+		// the rest of the command line are the queries
+		exit(queryDocDB(optarg, argv + optind, argc - optind));
+	    case OPT_TRACE:
+		if(!traceOpen(optarg))
+		    fprintf(stderr, _("Can't write trace file `%s'\n"), optarg);
+		break;
 	    case 'i':
     		showInherited = false;
 		break;
@@ -560,49 +715,66 @@ int main(int argc, char **argv)
 	}
 
     // Preload GIFs
-    if(!noGifs && !forceGifs && !doTeX)
+    if(!noGifs && !forceGifs && !doTeX && dbFile.length() == 0)
 	{
 	McString gifDB(outputDir);
 	gifDB += PATH_DELIMITER;
 	gifDB += GIF_FILE_NAME;
 
-  std::ifstream gifFile(gifDB.c_str());
-	if(gifFile)
+	if(!gifsFile.open(gifDB.c_str()))
 	    {
-            gifFile >> gifs;
-            gifNum = gifs.num();
-    	    }
+	    if(NameTableFile::isBinary(gifDB.c_str()))
+		{
+		// of another version or damaged, start a new one
+		fprintf(stderr,
+		    _("Removing unreadable GIF database file `%s'\n"),
+		    gifDB.c_str());
+		remove(gifDB.c_str());
+		}
+	    else
+		// convert a GIF database in the old text format
+		if(NameTableFile::convert(gifDB.c_str(), gifDB.c_str()) >= 0)
+		    gifsFile.open(gifDB.c_str());
+	    }
+	gifNum = gifsFile.num();
 	}
 
     // Read input files into buffer
     if(verb)
 	printf(_("Reading files...\n"));
+    beginPhase("read");
+
+    // the files are known in advance, so they can be prefetched
+    McDArray<McString *> listed;
+    McDArray<McString *> *names = &inputFiles;
 
     if(fileList.length() > 0)
 	{
-    std::ifstream i_file(fileList.c_str());
-	if(!i_file)
+	if(!readFileList(fileList, fileListNul ? '\0' : '\n', listed))
 	    {
             fprintf(stderr, _("Error opening file list `%s'\n"), fileList.c_str());
             exit(-1);
             }
-
-	char line[1024];
-	while(i_file)
-    	    {
-            i_file.getline(line, 1024);
-	    if(i_file)
-		readfile(&inputFile, line, 1);
-            }
-	i_file.close();
+	names = &listed;
 	}
     else
 	if(inputFiles.size() == 0)
+	    {
 	    for(i = optind; i < argc; i++)
-		readfile(&inputFile, argv[i], 1);
-	else
-	    for(i = 0; i < inputFiles.size(); i++)
-		readfile(&inputFile, inputFiles[i]->c_str(), 1);
+		listed.append(new McString(argv[i]));
+	    names = &listed;
+	    }
+
+    int ahead = 0;
+    for(i = 0; i < names->size(); i++)
+	{
+	for(; ahead < names->size() && ahead < i + PREFETCH_AHEAD; ahead++)
+	    prefetchFile((*names)[ahead]->c_str());
+	readfile(&inputFile, (*names)[i]->c_str(), 1);
+	}
+    for(i = 0; i < listed.size(); i++)
+	delete listed[i];
+    endPhase();
     if(verb)
 	printf(_("%d bytes read\n"), inputFile.length());
 
@@ -620,6 +792,8 @@ int main(int argc, char **argv)
     // Parse buffer
     if(verb)
 	printf(_("Parsing...\n"));
+    beginPhase("parse");
+    mcAllocScope = MC_TAG_ENTRY;
     if(language == LANG_JAVA)
 	parseJava(root);
     else
@@ -627,52 +801,125 @@ int main(int argc, char **argv)
 	    parsePHP(root);
 	else
 	    parseCpp(root);
+    endPhase();
 
+    beginPhase("packages");
     checkPackages(root);
     setupLanguageHash();
+    endPhase();
 
     // Merge duplicated entries, etc.
     if(verb)
 	printf(_("Merging duplicate entries...\n"));
+    beginPhase("merge");
     mergeEntries(root);
+    endPhase();
 
     // Sort entries
     if(verb)
 	printf(_("Sorting entries...\n"));
+    beginPhase("sort");
     makeSubLists(root);
+    endPhase();
 
     // Resolve references
     if(verb)
 	printf(_("Resolving references...\n"));
+    beginPhase("references");
     reNumber(root);
     root->makeRefs();
+    endPhase();
 
     // Create user manual
-    if(doTeX)
-	usermanTeX(inputFile, root);
+    beginPhase("output");
+    mcAllocScope = MC_TAG_OTHER;
+    if(dbFile.length() > 0)
+	{
+	if(verb)
+	    printf(_("Writing documentation database `%s'...\n"),
+		dbFile.c_str());
+	if(!DocDBFile::write(dbFile.c_str(), root))
+	    {
+	    fprintf(stderr, _("Can't write documentation database `%s'\n"),
+		dbFile.c_str());
+	    exit(-1);
+	    }
+	}
     else
-	if(doDOCBOOK)
-	    usermanDBsgml(inputFile, root);
-        else
-	    if(doDOCBOOKXML)
-		usermanDBxml(inputFile, root);
+	if(doTeX)
+	    usermanTeX(inputFile, root);
+	else
+	    if(doDOCBOOK)
+		usermanDBsgml(inputFile, root);
 	    else
-		doHTML(outputDir.c_str(), root);
+		if(doDOCBOOKXML)
+		    usermanDBxml(inputFile, root);
+		else
+		    {
+		    mcAllocScope = MC_TAG_HTML;
+		    doHTML(outputDir.c_str(), root);
+		    }
+    if(dbFile.length() == 0 && (doTeX || doDOCBOOK || doDOCBOOKXML))
+	{
+	// the whole manual is one file, its size is unknown on a pipe
+	fflush(out);
+	long n = ftell(out);
+	docStats.files++;
+	if(n > 0)
+	    docStats.fileBytes += n;
+	}
+    endPhase();
 
     // Create GIFs (if any)
-    gifNum = gifs.num();
+    gifNum = gifs.num() + gifsFile.num();
     if(gifNum > 0)
 	{
+	beginPhase("GIFs");
 	McString gifDB(outputDir);
 	gifDB += PATH_DELIMITER;
 	gifDB += GIF_FILE_NAME;
-	if(verb)
-	    printf(_("Writing GIF database file `%s'...\n"), gifDB.c_str());
 
-  std::ofstream gifFile(gifDB.c_str());
-	gifFile << gifs;
+	if(gifs.num() > 0)
+	    {
+	    if(verb)
+		printf(_("Writing GIF database file `%s'...\n"), gifDB.c_str());
+
+	    // the old file is still mapped, so write a new one and replace it
+	    McString newDB(gifDB);
+	    newDB += ".new";
+	    bool ok = NameTableFile::write(newDB.c_str(), gifs, &gifsFile);
+	    gifsFile.close();
+	    if(ok)
+		{
+		remove(gifDB.c_str());
+		ok = rename(newDB.c_str(), gifDB.c_str()) == 0;
+		}
+	    if(!ok)
+		fprintf(stderr, _("Can't write GIF database file `%s'\n"),
+		    gifDB.c_str());
+	    }
+	gifsFile.close();
 	makeGifs(outputDir.c_str(), GIF_FILE_NAME);
+	endPhase();
+	}
+
+    if(showStats || statsFile.length() > 0)
+	{
+	entryTableStats();
+	readfileStats();
+	if(!doTeX && !doDOCBOOK && !doDOCBOOKXML && dbFile.length() == 0)
+	    htmlStats();
+	if(showStats)
+	    printStats(stderr);
+	if(statsFile.length() > 0 && !writeStatsJSON(statsFile.c_str()))
+	    fprintf(stderr, _("Can't write statistics file `%s'\n"),
+		statsFile.c_str());
 	}
+    if(fileReport)
+	printFileReport(stderr, root);
+    if(memReport)
+	printMemReport(stderr);
+    traceClose();
 
     // That's all
     if(verb)
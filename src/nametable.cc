@@ -22,7 +22,10 @@
 */
 
 #include <assert.h>
+#include <fstream>
 #include <iostream>
+#include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -50,7 +53,7 @@ void NameTable::add(int num, const char *name)
     char *start = names;
 
     names.append(n, name);
-    int	delta = start - (char*)names;
+    ptrdiff_t delta = start - (char*)names;
     if(delta)
 	for(table.first(); table.current(); table.next())
 	    ((Name*)table.current())->name -= delta;
@@ -111,4 +114,190 @@ int NameTable::isConsistent() const
 
 NameTable::NameTable() : table(hashFunction), names(1000)
 {
+    names.setTag(MC_TAG_NAMES);
+    table.setAllocTag(MC_TAG_NAMES);
+}
+
+static const char nameTableMagic[8] = { 'D', 'X', 'X', 'N', 'T', 'A', 'B', 0 };
+static const unsigned int nameTableVersion = 1;
+static const unsigned int nameTableByteOrder = 0x01020304;
+
+static unsigned int nameHash(const char *str)
+{
+    const NameTable::Name nam(str);
+    return hashFunction(&nam);
+}
+
+bool NameTableFile::open(const char *path)
+{
+    close();
+
+    if(!file.open(path))
+	return false;
+
+    const char *base = file.data();
+    unsigned long size = file.size();
+    const Header *h = (const Header *)base;
+
+    if(size < sizeof(Header) || memcmp(h->magic, nameTableMagic, 8) != 0 ||
+	h->version != nameTableVersion || h->byteOrder != nameTableByteOrder ||
+	h->buckets == 0 || (h->buckets & (h->buckets - 1)) != 0 ||
+	size != sizeof(Header) + h->buckets * sizeof(unsigned int) +
+	    h->count * sizeof(Record) + h->namesSize)
+	{
+	file.close();
+	return false;
+	}
+
+    const unsigned int *ix = (const unsigned int *)(base + sizeof(Header));
+    const Record *rs = (const Record *)(ix + h->buckets);
+    const char *ns = (const char *)(rs + h->count);
+    unsigned int i;
+
+    // a damaged file must not make #find()# read behind it or loop forever
+    bool ok = h->count < h->buckets &&
+	(h->count == 0 || (h->namesSize > 0 && ns[h->namesSize - 1] == 0));
+    for(i = 0; ok && i < h->buckets; i++)
+	ok = ix[i] <= h->count;
+    for(i = 0; ok && i < h->count; i++)
+	ok = rs[i].offset < h->namesSize;
+    if(!ok)
+	{
+	file.close();
+	return false;
+	}
+
+    header = h;
+    index = ix;
+    records = rs;
+    names = ns;
+    return true;
+}
+
+bool NameTableFile::isBinary(const char *path)
+{
+    char magic[8];
+    FILE *in = fopen(path, "rb");
+
+    if(!in)
+	return false;
+    bool binary = fread(magic, 1, 8, in) == 8 &&
+	memcmp(magic, nameTableMagic, 8) == 0;
+    fclose(in);
+    return binary;
+}
+
+void NameTableFile::close()
+{
+    file.close();
+    header = 0;
+    index = 0;
+    records = 0;
+    names = 0;
+}
+
+int NameTableFile::find(const char *str) const
+{
+    if(!header)
+	return 0;
+
+    unsigned int hash = nameHash(str);
+    unsigned int mask = header->buckets - 1;
+
+    for(unsigned int i = hash & mask; index[i]; i = (i + 1) & mask)
+	{
+	const Record& r = records[index[i] - 1];
+	if(r.hash == hash && strcmp(names + r.offset, str) == 0)
+	    return r.number;
+	}
+    return 0;
+}
+
+bool NameTableFile::write(const char *path, const NameTable& table,
+    const NameTableFile *base)
+{
+    Header h;
+    McDArray<Record> records;
+    McDArray<char> names;
+    int i;
+
+    if(base)
+	for(i = 0; i < base->num(); i++)
+	    {
+	    Record r;
+	    r.hash = base->records[i].hash;
+	    r.number = base->records[i].number;
+	    r.offset = names.size();
+	    records.append(r);
+	    names.append(strlen(base->name(i)) + 1, base->name(i));
+	    }
+
+    for(table.first(); table.current(); table.next())
+	{
+	Record r;
+	r.hash = nameHash(table.current());
+	r.number = table[table.current()];
+	r.offset = names.size();
+	records.append(r);
+	names.append(strlen(table.current()) + 1, table.current());
+	}
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, nameTableMagic, 8);
+    h.version = nameTableVersion;
+    h.byteOrder = nameTableByteOrder;
+    h.count = records.size();
+    h.maxNumber = 0;
+    h.namesSize = names.size();
+
+    // keep the index at most half full
+    for(h.buckets = 8; h.buckets < 2 * h.count; h.buckets *= 2)
+	;
+    McDArray<unsigned int> index(h.buckets);
+    for(i = 0; i < (int)h.buckets; i++)
+	index[i] = 0;
+
+    for(i = 0; i < records.size(); i++)
+	{
+	unsigned int j = records[i].hash & (h.buckets - 1);
+	while(index[j])
+	    j = (j + 1) & (h.buckets - 1);
+	index[j] = i + 1;
+	if(records[i].number > h.maxNumber)
+	    h.maxNumber = records[i].number;
+	}
+
+    FILE *out = fopen(path, "wb");
+    if(!out)
+	return false;
+
+    fwrite(&h, sizeof(h), 1, out);
+    if(h.buckets)
+	fwrite((unsigned int *)index, sizeof(unsigned int), h.buckets, out);
+    if(records.size())
+	fwrite((Record *)records, sizeof(Record), records.size(), out);
+    if(names.size())
+	fwrite((char *)names, 1, names.size(), out);
+
+    return fclose(out) == 0;
+}
+
+int NameTableFile::convert(const char *from, const char *to)
+{
+    NameTable table;
+
+    // a damaged binary file would read as an empty table
+    if(isBinary(from))
+	return -1;
+
+    std::ifstream in(from);
+
+    if(!in)
+	return -1;
+    in >> table;
+    in.close();
+
+    if(!write(to, table))
+	return -1;
+    return table.num();
 }
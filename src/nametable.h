@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <iostream>
 
+#include "McMappedFile.h"
 #include "datahashtable.h"
 
 /** Maps names to names.
@@ -158,4 +159,114 @@ public:
     NameTable();
 };
 
+/** Read-only view of a #NameTable# saved in binary form.
+
+    The file consists of a header, an open addressing hash index and the
+    table of records, followed by one block with all names. It is mapped into
+    memory by #open()# and looked up in place, so opening a large file costs
+    next to nothing. Files are written with #write()#; a file in the text
+    format of #operator<<(std::ostream&, const NameTable&)# is recognized by
+    #open()# failing and can be converted with #convert()#.
+*/
+class NameTableFile
+{
+public:
+    /// binary layout of the file header
+    struct Header
+	{
+	char magic[8];
+	unsigned int version;
+	unsigned int byteOrder;
+	unsigned int count;		// nr. of records
+	int maxNumber;			// largest number of all records
+	unsigned int buckets;		// size of the hash index, a power of 2
+	unsigned int namesSize;		// size of the name block in bytes
+	};
+
+    /// binary layout of one record
+    struct Record
+	{
+	unsigned int hash;
+	int number;
+	unsigned int offset;		// position in the name block
+	};
+
+    /// map #path#, returns #false# if it is not a binary name table
+    bool open(const char *path);
+
+    /** Does #path# start like a binary name table? If so, but #open()#
+	fails, it is of another version or damaged, not a text file.
+     */
+    static bool isBinary(const char *path);
+
+    void close();
+
+    bool isOpen() const
+	{
+	return header != 0;
+	}
+
+    ///	return nr. of names in the file
+    int num() const
+	{
+	return header ? (int)header->count : 0;
+	}
+
+    /// return the largest number used in the file
+    int maxNumber() const
+	{
+	return header ? header->maxNumber : 0;
+	}
+
+    /// return the number for #str#, or 0 if it is not in the file
+    int find(const char *str) const;
+
+    ///	does the file have name #str#?
+    int has(const char *str) const
+	{
+	return find(str) != 0;
+	}
+
+    ///	return number for #name#
+    int operator [] (const char *str) const
+	{
+	return find(str);
+	}
+
+    /// return the #i#-th name
+    const char *name(int i) const
+	{
+	return names + records[i].offset;
+	}
+
+    /// return the number of the #i#-th name
+    int number(int i) const
+	{
+	return records[i].number;
+	}
+
+    /** Write the names of #table# and, if given, of #base# to #path#. The
+	names of both must be distinct.
+     */
+    static bool write(const char *path, const NameTable& table,
+	const NameTableFile *base = 0);
+
+    /** Convert the text file #from# to the binary file #to#. Returns the
+	nr. of names converted or -1 if #from# could not be read or is a
+	binary file.
+     */
+    static int convert(const char *from, const char *to);
+
+    NameTableFile() : header(0), index(0), records(0), names(0)
+	{
+	}
+
+private:
+    McMappedFile file;
+    const Header *header;
+    const unsigned int *index;
+    const Record *records;
+    const char *names;
+};
+
 #endif
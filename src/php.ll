@@ -27,6 +27,8 @@
 #include <stdio.h>
 
 #include "doc.h"
+#include "stats.h"
+#include "yyread.h"
 
 static const char	*inputString;
 static int		inputPosition;
@@ -73,15 +75,7 @@ static void lineCount()
 
 static int yyread(char *buf, int max_size)
 {
-    int c = 0;
-
-    while(c < max_size && inputString[inputPosition])
-	{
-	*buf = inputString[inputPosition++];
-	c++;
-	buf++;
-	}
-    return c;
+    return yyReadString(buf, max_size, inputString, inputPosition);
 }
 
 %}
@@ -129,6 +123,7 @@ static int yyread(char *buf, int max_size)
 					for(i = 0; yytext[i + 1] != 6; i++)
 					    yyFileName[i] = yytext[i + 1];
 					yyFileName[i] = 0;
+					costParse(yyFileName);
 					current_root  = global_root;
 					}
 <FindClasses>[ \t]*"class"[ \t]+	{
@@ -150,7 +145,7 @@ static int yyread(char *buf, int max_size)
 					}
 
 <Require>[a-z_A-Z0-9.*]*		{
-					current->import.append(new McString(yytext));
+					current->extra().import.append(new McString(yytext));
 					}
 
 <Require>;				{
@@ -158,7 +153,7 @@ static int yyread(char *buf, int max_size)
 					}
 
 <Include>[a-z_A-Z0-9.*]*		{
-					current->import.append(new McString(yytext));
+					current->extra().import.append(new McString(yytext));
 					}
 
 <Include>;				{
@@ -181,7 +176,7 @@ static int yyread(char *buf, int max_size)
 					}
 
 <Extends>[a-z_A-Z.0-9]+			{
-					current->extends.append(new McString(yytext));
+					current->extra().extends.append(new McString(yytext));
 					msg(" Extends : ",yytext);
 					BEGIN(ClassName);
 					}
@@ -473,8 +468,10 @@ void parsePHPClasses(Entry *rt)
 {
     if(rt == 0)
 	return;
-    for(Entry *cr = rt->sub; cr; cr = cr->next)
+    for(int i = 0; i < rt->subEntries.size(); i++)
 	{
+	Entry *cr = rt->subEntries[i];
+
 	if(cr->program.length())
 	    {
 	    inputString = cr->program.c_str();
@@ -488,7 +485,9 @@ void parsePHPClasses(Entry *rt)
 	    current_root = cr;
 	    strcpy(yyFileName, cr->file.c_str());
 	    yyLineNr = cr->startLine;
+	    costParse(yyFileName);
 	    phpYYlex();
+	    costParse(0);
 	    cr->program.clear();
 	    }
 	parsePHPClasses(cr);
@@ -513,6 +512,7 @@ void parsePHP(Entry *rt)
     findClasses = true;
 
     phpYYlex();
+    costParse(0);
     rt->program.clear();
 
     parsePHPClasses(rt);
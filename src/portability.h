@@ -50,6 +50,16 @@ inline int isatty(const int handle)
     return _isatty(handle);
 }
 
+inline int pclose(FILE* const stream)
+{
+    return _pclose(stream);
+}
+
+inline FILE* popen(const char* const command, const char* const mode)
+{
+    return _popen(command, mode);
+}
+
 inline char* strdup(const char* const strSource)
 {
     return _strdup(strSource);
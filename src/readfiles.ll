@@ -25,15 +25,29 @@
 %{
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/types.h>
+#if !defined(WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
+#include "McAlloc.h"
 #include "McDirectory.h"
+#include "McGlobSet.h"
 #include "McSorter.h"
 #include "McString.h"
 #include "doc.h"
 #include "nametable.h"
-
-static NameTable	fileTable;
+#include "stats.h"
+
+static NameTable	fileTable;	// paths asked for
+static NameTable	fileIds;	// device and inode or contents of a file
+static McDArray<char*>	filesRead;	// by the numbers in fileIds
+static McGlobSet	includeSet;	// includeFiles, compiled
+static McGlobSet	excludeSet;	// excludeFiles, compiled
+static bool		patternsCompiled = false;
 static McString*	inputFile;
 static McString		fileName;
 static McString		currDir;
@@ -269,6 +283,92 @@ extern "C" {
 
 %%
 
+/* Reads all of #f# into a buffer followed by the two 0 characters flex
+   needs at its end. Returns the buffer and its length in #length#. If
+   #hash# is given, the hash of the contents is taken while they are read.
+*/
+static char *readAll(FILE *f, long& length, unsigned long *hash = 0)
+{
+    long max = 16384;
+    char *text = (char *)mcMalloc(max + 2, MC_TAG_SCANNER);
+    unsigned long h = 2166136261UL;
+    size_t n;
+
+    length = 0;
+    while((n = fread(text + length, 1, max - length, f)) > 0)
+	{
+	if(hash)
+	    for(size_t i = 0; i < n; i++)
+		h = (h ^ (unsigned char)text[length + i]) * 16777619UL;
+	length += n;
+	if(length == max)
+	    {
+	    text = (char *)mcRealloc(text, max + 2, 2 * max + 2,
+		MC_TAG_SCANNER);
+	    max *= 2;
+	    }
+	}
+    text = (char *)mcRealloc(text, max + 2, length + 2, MC_TAG_SCANNER);
+    text[length] = text[length + 1] = 0;
+    if(hash)
+	*hash = h;
+    return text;
+}
+
+// true if the file #path# holds the #length# characters at #text#
+static bool sameContents(const char *path, const char *text, long length)
+{
+    FILE *f = fopen(path, "r");
+    bool same = false;
+
+    if(f)
+	{
+	long n;
+	char *other = readAll(f, n);
+	same = n == length && memcmp(other, text, length) == 0;
+	mcFree(other, n + 2, MC_TAG_SCANNER);
+	fclose(f);
+	}
+    return same;
+}
+
+static void compilePatterns()
+{
+    int i;
+
+    for(i = 0; i < includeFiles.size(); i++)
+	includeSet.add(includeFiles[i]->c_str());
+    for(i = 0; i < excludeFiles.size(); i++)
+	excludeSet.add(excludeFiles[i]->c_str());
+    patternsCompiled = true;
+}
+
+/* Asks the system to read the file #path# in the background, so that it is
+   in memory when it is read. Waiting for the disk or the network then
+   overlaps with scanning the files before it.
+*/
+void prefetchFile(const char *path)
+{
+#if defined(POSIX_FADV_WILLNEED)
+    int fd = open(path, O_RDONLY);
+
+    if(fd >= 0)
+	{
+	posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+	close(fd);
+	}
+#endif
+}
+
+// #path# is not read, since it is the same as the file with identity #id#
+static void skipFile(const McString& path, const char *id)
+{
+    if(verb)
+	printf(_("`%s' is the same file as `%s', not read again\n"),
+	    path.c_str(), filesRead[fileIds[id]]);
+    docStats.skippedFiles++;
+}
+
 /** Read files prior to extracting documentation.
 
    @param in The input text to document
@@ -281,38 +381,39 @@ void readfile(McString *in, const char *file, int startLine,
     const McString& directory, int scanSubDirs)
 {
     McString path;    
-    int i, n = 0;
+    int i;
+
+    if(!patternsCompiled)
+	compilePatterns();
 
-    /* If we're told to scan sub-directories and there's a directory, recurse
-       to get all header files in sub-directories
+    /* If we're told to scan sub-directories and there's a directory, read
+       the files matching #file# in the whole tree below it. The tree is
+       walked once, excluded subtrees are not entered.
     */
     if(scanSubDirs && directory.length() > 0)
 	{
-	McString d = directory;
 	McDArray<char *> list;
-        McDirectory::scan(d, list, "*");
+	int ahead = 0;
+
+	McDirectory::walk(directory, list, file, includeSet, excludeSet);
 #ifdef DEBUG
 	if(verb)
-	    printf("Scanning for subdirs in `%s', found %d files\n",
-		d.c_str(), list.size());
+	    printf("Scanned `%s', found %d files\n", directory.c_str(),
+		list.size());
 #endif
 	for(i = 0; i < list.size(); i++)
 	    {
-	    McString tmp = d;
-	    tmp += McDirectory::pathDelimiter();
-	    tmp += list[i];
-	    if(McDirectory::isDirectory(tmp))
-		{
-		readfile(in, file, 1, tmp, 1);
-		n++;
-		}
+	    McString found = list[i];
+	    int slash = found.rindex(McDirectory::pathDelimiter());
+
+	    for(; ahead < list.size() && ahead < i + PREFETCH_AHEAD; ahead++)
+		prefetchFile(list[ahead]);
+
+	    // read as before, with the name apart from its directory
+	    readfile(in, list[i] + slash + 1, 1, McString(found, 0, slash + 1));
 	    free(list[i]);
 	    }
-#ifdef DEBUG
-	if(verb)
-	    printf("done scanning for subdirs in `%s', found %d files\n",
-		d.c_str(), n);
-#endif
+	return;
 	}
 
     /* Set our path to be the directory unless the file starts with a path
@@ -360,7 +461,9 @@ void readfile(McString *in, const char *file, int startLine,
 	    dr = ".";
 	    dr += McDirectory::pathDelimiter();
 	    }	
+	McString anchor = currDir;
 	McDArray<char *> list;
+	int ahead = 0;
 	McDirectory::scan(dr, list, realFile.c_str());
 
 #ifdef DEBUG
@@ -370,7 +473,17 @@ void readfile(McString *in, const char *file, int startLine,
 #endif
 	for(i = 0; i < list.size(); i++)
 	    {
-	    readfile(in, list[i], 1, dr);
+	    for(; ahead < list.size() && ahead < i + PREFETCH_AHEAD; ahead++)
+		{
+		McString next = dr;
+		next += list[ahead];
+		prefetchFile(next.c_str());
+		}
+	    // excludes see the path as given, with the directory of the pattern
+	    McString rel = anchor;
+	    rel += list[i];
+	    if(!excludeSet.matches(rel.c_str()))
+		readfile(in, list[i], 1, dr);
 	    free(list[i]);
 	    }
 	return;
@@ -385,7 +498,7 @@ void readfile(McString *in, const char *file, int startLine,
 	if(java)
 	    readfile(in, "*.java", 1, path, 1);
 	else
-	    readfile(in, "*.h*", 1, realFile, 1);
+	    readfile(in, "*.h*", 1, path, 1);
 	return;
 	}
 
@@ -397,28 +510,81 @@ void readfile(McString *in, const char *file, int startLine,
     FILE *newin = fopen(path.c_str(), "r");
     if(newin)
 	{
-        yyin = newin;
+	char node[64], id[64];
+	long length;
+	unsigned long hash;
+
         fileTable.add(0, path.c_str());
+
+	/* The same file may be asked for under other names, through `..' or
+	   symbolic links, or be a copy of one read already. It is neither
+	   read nor parsed twice.
+	*/
+	node[0] = 0;
+#if !defined(WIN32)
+	struct stat st;
+
+	if(fstat(fileno(newin), &st) == 0)
+	    {
+	    sprintf(node, "%lx:%lx", (unsigned long)st.st_dev,
+		(unsigned long)st.st_ino);
+	    if(fileIds.has(node))
+		{
+		skipFile(path, node);
+		fclose(newin);
+		return;
+		}
+	    }
+#endif
+	char *text = readAll(newin, length, &hash);
+
+	fclose(newin);
+	sprintf(id, "%ld/%lx", length, hash);
+	if(fileIds.has(id))
+	    {
+	    if(sameContents(filesRead[fileIds[id]], text, length))
+		{
+		skipFile(path, id);
+		mcFree(text, length + 2, MC_TAG_SCANNER);
+		return;
+		}
+	    }
+	else
+	    fileIds.add(filesRead.size(), id);
+	if(node[0])
+	    fileIds.add(filesRead.size(), node);
+	filesRead.append(strdup(path.c_str()));
+
         inputFile = in;
         if(showFilePath)
 	    startfile(path, startLine);
 	else
 	    startfile(file, startLine);
-        yy_switch_to_buffer(yy_create_buffer(yyin, YY_BUF_SIZE));
+	YY_BUFFER_STATE buffer = yy_scan_buffer(text, length + 2);
 	BEGIN(0);
 	int lastobr = obr;
 	int lastcbr = cbr;
 	obr = 0;
 	cbr = 0;
+	traceBegin("file", path.c_str());
 	readfilesYYlex();
+	traceEnd();
+	if(fileReport)
+	    fileCost(showFilePath ? path.c_str() : file)->bytes += length;
 	if(obr != cbr)
 	    fprintf(stderr, "Warning: %d opening `{', but %d closing `}' in file `%s'.\n",
 		obr, cbr, path.c_str());
 	obr = lastobr;
 	cbr = lastcbr;
-	
-	fclose(yyin);
+
+	yy_delete_buffer(buffer);
+	mcFree(text, length + 2, MC_TAG_SCANNER);
 	}
     else
 	fprintf(stderr, _("Could not open `%s'\n"), path.c_str());
 }
+
+void readfileStats()
+{
+    statsTable("input files", fileTable.num(), fileTable.max());
+}
@@ -0,0 +1,396 @@
+/*
+  stats.cc
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this library; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if !defined(WIN32) && !defined(__BORLANDC__) && !defined(__VISUALC__) && !defined(__WATCOMC__) && !defined(__MINGW32__)
+#define HAVE_RUSAGE
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+#include "McAlloc.h"
+#include "McDArray.h"
+#include "McHashTable.h"
+#include "McSorter.h"
+#include "doc.h"
+#include "stats.h"
+
+DocStats docStats;
+
+struct Phase
+{
+    const char *name;
+    int depth;
+    double wall;		// seconds
+    double cpu;			// seconds
+    long rss;			// peak resident set size in KB
+};
+
+struct TableStat
+{
+    const char *name;
+    int items;
+    int buckets;
+};
+
+static McDArray<Phase> phases;
+static McDArray<int> running;	// indices of the phases not yet ended
+static McDArray<TableStat> tables;
+
+bool fileReport = false;
+static McDArray<FileCost *> costs;
+static McHashTable<const char *, int> costIndex(-1);
+static FileCost *parsed = 0;	// file being timed by costParse()
+static double parseStart;
+
+static FILE *traceOut = 0;
+static double traceStart;
+static bool traceFirst;
+
+static double wallTime()
+{
+#ifdef HAVE_RUSAGE
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+#else
+    return (double)time(0);
+#endif
+}
+
+static double cpuTime()
+{
+#ifdef HAVE_RUSAGE
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 +
+	ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+static long peakRSS()
+{
+#ifdef HAVE_RUSAGE
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+    return ru.ru_maxrss / 1024;		// bytes on Darwin
+#else
+    return ru.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+void beginPhase(const char *name)
+{
+    Phase p;
+
+    p.name = name;
+    p.depth = running.size();
+    p.wall = wallTime();
+    p.cpu = cpuTime();
+    p.rss = 0;
+    running.append(phases.size());
+    phases.append(p);
+    traceBegin("phase", name);
+}
+
+void endPhase()
+{
+    if(running.size() == 0)
+	return;
+
+    Phase& p = phases[running.last()];
+    p.wall = wallTime() - p.wall;
+    p.cpu = cpuTime() - p.cpu;
+    p.rss = peakRSS();
+    running.removeLast();
+    traceEnd();
+}
+
+void statsTable(const char *name, int items, int buckets)
+{
+    TableStat t;
+
+    t.name = name;
+    t.items = items;
+    t.buckets = buckets;
+    tables.append(t);
+}
+
+static double loadFactor(const TableStat& t)
+{
+    return t.buckets > 0 ? (double)t.items / t.buckets : 0;
+}
+
+void printStats(FILE *out)
+{
+    int i;
+
+    fprintf(out, _("\nPhase                          Wall (s)   CPU (s)  Peak RSS (KB)\n"));
+    for(i = 0; i < phases.size(); i++)
+	{
+	const Phase& p = phases[i];
+	fprintf(out, "%*s%-*s %9.3f %9.3f %14ld\n", 2 * p.depth, "",
+	    30 - 2 * p.depth, p.name, p.wall, p.cpu, p.rss);
+	}
+    fprintf(out, _("Peak RSS: %ld KB\n\n"), peakRSS());
+
+    fprintf(out, _("Entries created:               %10ld\n"), docStats.entries);
+    fprintf(out, _("Input files not read again:    %10ld\n"), docStats.skippedFiles);
+    fprintf(out, _("Class bodies skipped:          %10ld\n"), docStats.skippedBodies);
+    fprintf(out, _("Reference searches:            %10ld\n"), docStats.refSearches);
+    fprintf(out, _("  answered from cache:         %10ld\n"), docStats.refCacheHits);
+    fprintf(out, _("HTML conversions:              %10ld\n"), docStats.htmlConversions);
+    fprintf(out, _("  bytes produced:              %10ld\n"), docStats.htmlBytes);
+    fprintf(out, _("Files written:                 %10ld\n"), docStats.files);
+    fprintf(out, _("  bytes written:               %10ld\n"), docStats.fileBytes);
+
+    if(tables.size())
+	{
+	fprintf(out, _("\nHash table                        Items   Buckets  Load\n"));
+	for(i = 0; i < tables.size(); i++)
+	    fprintf(out, "%-30s %8d %9d %5.2f\n", tables[i].name,
+		tables[i].items, tables[i].buckets, loadFactor(tables[i]));
+	}
+}
+
+bool writeStatsJSON(const char *file)
+{
+    int i;
+    FILE *out = fopen(file, "w");
+
+    if(!out)
+	return false;
+
+    fprintf(out, "{\n  \"version\": \"%s\",\n", DOCXX_VERSION);
+    fprintf(out, "  \"peak_rss_kb\": %ld,\n", peakRSS());
+
+    fprintf(out, "  \"phases\": [");
+    for(i = 0; i < phases.size(); i++)
+	{
+	const Phase& p = phases[i];
+	fprintf(out, "%s\n    { \"name\": \"%s\", \"depth\": %d, \"wall\": %.6f, "
+	    "\"cpu\": %.6f, \"rss_kb\": %ld }", i ? "," : "", p.name, p.depth,
+	    p.wall, p.cpu, p.rss);
+	}
+    fprintf(out, "\n  ],\n");
+
+    fprintf(out, "  \"counters\": {\n");
+    fprintf(out, "    \"entries\": %ld,\n", docStats.entries);
+    fprintf(out, "    \"skipped_files\": %ld,\n", docStats.skippedFiles);
+    fprintf(out, "    \"skipped_bodies\": %ld,\n", docStats.skippedBodies);
+    fprintf(out, "    \"ref_searches\": %ld,\n", docStats.refSearches);
+    fprintf(out, "    \"ref_cache_hits\": %ld,\n", docStats.refCacheHits);
+    fprintf(out, "    \"html_conversions\": %ld,\n", docStats.htmlConversions);
+    fprintf(out, "    \"html_bytes\": %ld,\n", docStats.htmlBytes);
+    fprintf(out, "    \"files\": %ld,\n", docStats.files);
+    fprintf(out, "    \"file_bytes\": %ld\n", docStats.fileBytes);
+    fprintf(out, "  },\n");
+
+    fprintf(out, "  \"hash_tables\": [");
+    for(i = 0; i < tables.size(); i++)
+	fprintf(out, "%s\n    { \"name\": \"%s\", \"items\": %d, \"buckets\": %d, "
+	    "\"load\": %.4f }", i ? "," : "", tables[i].name, tables[i].items,
+	    tables[i].buckets, loadFactor(tables[i]));
+    fprintf(out, "\n  ]\n}\n");
+
+    return fclose(out) == 0;
+}
+
+static void traceString(const char *str)
+{
+    fputc('"', traceOut);
+    for(; *str; str++)
+	if(*str == '"' || *str == '\\')
+	    fprintf(traceOut, "\\%c", *str);
+	else
+	    if((unsigned char)*str < ' ')
+		fprintf(traceOut, "\\u%04x", (unsigned char)*str);
+	    else
+		fputc(*str, traceOut);
+    fputc('"', traceOut);
+}
+
+// Starts a new event of type #ph#; the caller adds further fields and `}'
+static void traceEvent(char ph)
+{
+    fprintf(traceOut, "%s\n{\"ph\":\"%c\",\"pid\":1,\"tid\":1,\"ts\":%.0f",
+	traceFirst ? "" : ",", ph, (wallTime() - traceStart) * 1e6);
+    traceFirst = false;
+}
+
+bool traceOpen(const char *file)
+{
+    if(!(traceOut = fopen(file, "w")))
+	return false;
+
+    // A JSON array of events; Chrome accepts it even if the run dies
+    // before the closing bracket is written
+    fprintf(traceOut, "[");
+    traceStart = wallTime();
+    traceFirst = true;
+    return true;
+}
+
+void traceBegin(const char *cat, const char *name, const char *detail)
+{
+    if(!traceOut)
+	return;
+
+    traceEvent('B');
+    fprintf(traceOut, ",\"cat\":");
+    traceString(cat);
+    fprintf(traceOut, ",\"name\":");
+    traceString(name);
+    if(detail)
+	{
+	fprintf(traceOut, ",\"args\":{\"detail\":");
+	traceString(detail);
+	fprintf(traceOut, "}");
+	}
+    fprintf(traceOut, "}");
+}
+
+void traceEnd()
+{
+    if(!traceOut)
+	return;
+
+    traceEvent('E');
+    fprintf(traceOut, "}");
+}
+
+void traceClose()
+{
+    if(!traceOut)
+	return;
+
+    fprintf(traceOut, "\n]\n");
+    fclose(traceOut);
+    traceOut = 0;
+}
+
+double statsClock()
+{
+    return wallTime();
+}
+
+FileCost *fileCost(const char *file)
+{
+    int *idx = costIndex.lookup(file);
+
+    if(idx)
+	return costs[*idx];
+
+    FileCost *c = new FileCost;
+    c->name = strdup(file);
+    c->bytes = c->entries = c->htmlBytes = 0;
+    c->parse = c->refs = c->html = 0;
+    costIndex.insert(c->name, costs.size());
+    costs.append(c);
+    return c;
+}
+
+void costParse(const char *file)
+{
+    if(!fileReport)
+	return;
+
+    double now = wallTime();
+    if(parsed)
+	parsed->parse += now - parseStart;
+    parsed = file ? fileCost(file) : 0;
+    parseStart = now;
+}
+
+static void countEntries(Entry *e)
+{
+    int i;
+
+    if(e->file.length() > 0)
+	fileCost(e->file.c_str())->entries++;
+    for(i = 0; i < e->subEntries.size(); i++)
+	countEntries(e->subEntries[i]);
+}
+
+static double totalCost(const FileCost *c)
+{
+    return c->parse + c->refs + c->html;
+}
+
+class CostCompare
+{
+public:
+    int operator()(FileCost *c1, FileCost *c2)
+	{
+	double t1 = totalCost(c1), t2 = totalCost(c2);
+	if(t1 != t2)
+	    return t1 > t2 ? -1 : 1;
+	if(c1->bytes != c2->bytes)
+	    return c1->bytes > c2->bytes ? -1 : 1;
+	return strcmp(c1->name, c2->name);
+	}
+};
+
+void printFileReport(FILE *out, Entry *root)
+{
+    CostCompare comp;
+    int i;
+
+    countEntries(root);
+    if(costs.size())
+	sort((FileCost **)costs, costs.size(), comp, 0);
+
+    fprintf(out, _("\n   Bytes  Entries  Parse (s)   Refs (s)   HTML (s)  HTML bytes  File\n"));
+    for(i = 0; i < costs.size(); i++)
+	{
+	const FileCost *c = costs[i];
+	fprintf(out, "%8ld %8ld %10.3f %10.3f %10.3f %11ld  %s\n", c->bytes,
+	    c->entries, c->parse, c->refs, c->html, c->htmlBytes, c->name);
+	}
+}
+
+void printMemReport(FILE *out)
+{
+    McAllocCount total = { 0, 0, 0 };
+    int i;
+
+    fprintf(out, _("\nMemory        Live (kB)  Peak (kB)  Allocations\n"));
+    for(i = 0; i < MC_NUM_TAGS; i++)
+	{
+	const McAllocCount& c = mcAllocCounts[i];
+	fprintf(out, "%-12s %10ld %10ld %12ld\n", mcAllocTagName(i),
+	    c.live / 1024, c.peak / 1024, c.count);
+	total.live += c.live;
+	total.count += c.count;
+	}
+    // the peaks of the tags are not reached at the same time
+    fprintf(out, "%-12s %10ld %10s %12ld\n", _("total"), total.live / 1024,
+	"-", total.count);
+    fprintf(out, _("peak RSS (kB) %ld\n"), peakRSS());
+}
@@ -0,0 +1,132 @@
+/*
+  stats.h
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this library; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef _STATS_H
+#define _STATS_H
+
+#include <stdio.h>
+
+class Entry;
+
+/// Counters reported with `#--stats#'
+struct DocStats
+{
+    long entries;		// #Entry# objects created
+    long skippedFiles;		// input files not read again, see #readfile()#
+    long skippedBodies;		// class bodies not parsed, see #parseCppClasses()#
+    long refSearches;		// calls of #searchRefEntry()#
+    long refCacheHits;		// of which answered by its cache
+    long htmlConversions;	// calls of #strToHtml()# and #seeToHtml()#
+    long htmlBytes;		// bytes returned by them
+    long files;			// output files written
+    long fileBytes;		// bytes written to them
+};
+
+extern DocStats docStats;
+
+/** @name Phases
+
+    The run of DOC++ is divided into phases, which may be nested. For every
+    phase the wall clock time, the CPU time and the peak resident set size
+    at its end are recorded.
+*/
+//@{
+/// start a new phase named #name#, which must be a static string
+void beginPhase(const char *name);
+
+/// end the phase started last
+void endPhase();
+//@}
+
+/// record the fill of hash table #name# for the report
+void statsTable(const char *name, int items, int buckets);
+
+/// print a report of phases, counters and hash tables to #out#
+void printStats(FILE *out);
+
+/// write the same report as JSON to #file#, returns #false# on failure
+bool writeStatsJSON(const char *file);
+
+/** @name Per-file costs
+
+    With `#--file-report#' the time spent on parsing, resolving references
+    and converting to HTML is charged to the input file the work was done
+    for, so that the most expensive headers can be found. #Entry::file# is
+    used to tell where an entry came from.
+*/
+//@{
+/// What has been spent on one input file
+struct FileCost
+{
+    char *name;
+    long bytes;			// bytes read
+    long entries;		// entries left after parsing
+    double parse;		// seconds spent in the parsers
+    double refs;		// seconds spent resolving base classes
+    double html;		// seconds spent converting to HTML
+    long htmlBytes;		// HTML generated for its entries
+};
+
+/// true if costs per file are to be collected (#--file-report#)
+extern bool fileReport;
+
+/// wall clock time in seconds, for timing the costs
+double statsClock();
+
+/// the costs of #file#, created on first use
+FileCost *fileCost(const char *file);
+
+/** Charge the parse time since the last call to the file given then and
+    start timing #file#. Call with 0 when the parser stops.
+*/
+void costParse(const char *file);
+
+/// print the costs of all files to #out#, most expensive first
+void printFileReport(FILE *out, Entry *root);
+//@}
+
+/** print the live and peak bytes and the number of allocations of every
+    McAllocTag to #out# (#--mem-report#)
+*/
+void printMemReport(FILE *out);
+
+/** @name Tracing
+
+    With `#--trace FILE#' every phase and a number of finer spans (input
+    files, class bodies, pages, external programs) are streamed to a file
+    in the Chrome trace event format, which can be loaded into
+    #chrome://tracing# or Perfetto. Spans must be properly nested. All
+    functions do nothing unless #traceOpen()# succeeded.
+*/
+//@{
+/// start writing trace events to #file#, returns #false# on failure
+bool traceOpen(const char *file);
+
+/// open a span of category #cat# named #name#, with an optional detail
+void traceBegin(const char *cat, const char *name, const char *detail = 0);
+
+/// close the span opened last
+void traceEnd();
+
+/// finish the trace file
+void traceClose();
+//@}
+
+#endif
@@ -36,25 +36,303 @@
 
 #include "doc.h"
 #include "nametable.h"
+#include "stats.h"
 #include "tex2gif.h"
 
+// Names a child process span in the trace after the program it runs
+static void traceProcess(const char *b)
+{
+    char prog[32];
+
+    sscanf(b, "%31s", prog);
+    traceBegin("process", prog, b);
+}
+
 void _system(const char *b)
 {
 #ifdef DEBUG
     printf(_("Running `%s'\n"), b);
 #endif
+    traceProcess(b);
     system(b);
+    traceEnd();
+}
+
+/// Resolution factor between PostScript points and rendered pixels
+static const int resfac = 4;
+
+/// Gray level of the GIF background, maps to `ac/ac/ac' after `pnmgamma .9'
+static const int backGray = 179;
+
+/// Reads the header of a raw PPM image; returns false at end of stream
+static bool readPPMHeader(FILE *in, int& width, int& height, int& maxval)
+{
+    int c, i, field[3];
+
+    if(getc(in) != 'P' || getc(in) != '6')
+	return false;
+
+    for(i = 0; i < 3; i++)
+	{
+	c = getc(in);
+	while(c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '#')
+	    {
+	    if(c == '#')
+		while(c != '\n' && c != EOF)
+		    c = getc(in);
+	    c = getc(in);
+	    }
+	if(c < '0' || c > '9')
+	    return false;
+	for(field[i] = 0; c >= '0' && c <= '9'; c = getc(in))
+	    field[i] = field[i] * 10 + c - '0';
+	}
+
+    // exactly one whitespace character separates header and raster
+    width = field[0];
+    height = field[1];
+    maxval = field[2];
+    return width > 0 && height > 0 && maxval > 0 && maxval < 256;
+}
+
+/** Copies the area #x1 y1 x2 y2# (in points) out of the PPM page read from
+    #in# and writes it to #dxxtmp.pnm#, putting the GIF background color
+    where the page is blank. The rest of the page is skipped.
+ */
+static bool cropPage(FILE *in, int x1, int y1, int x2, int y2)
+{
+    int width, height, maxval, x, y;
+
+    if(!readPPMHeader(in, width, height, maxval))
+	return false;
+
+    int gx = (x2 - x1) * resfac;
+    int gy = (y2 - y1) * resfac;
+    gx = ((gx + 7) / 8) * 8;
+    if(gx <= 0 || gy <= 0)
+	gx = gy = 8;
+
+    // PostScript has its origin at the lower left corner of the page
+    int left = x1 * resfac;
+    int top = height - y2 * resfac;
+
+    unsigned char *row = (unsigned char *)malloc(width * 3);
+    unsigned char *crop = (unsigned char *)malloc(gx * gy * 3);
+    memset(crop, backGray, gx * gy * 3);
+
+    bool ok = true;
+    for(y = 0; y < height && ok; y++)
+	{
+	if(fread(row, 3, width, in) != (size_t)width)
+	    ok = false;
+	else if(y >= top && y < top + gy)
+	    {
+	    unsigned char *dest = crop + (y - top) * gx * 3;
+	    for(x = 0; x < gx; x++)
+		{
+		int px = left + x;
+		if(px < 0 || px >= width)
+		    continue;
+		unsigned char *p = row + px * 3;
+		if(p[0] != maxval || p[1] != maxval || p[2] != maxval)
+		    {
+		    dest[x * 3] = p[0] * 255 / maxval;
+		    dest[x * 3 + 1] = p[1] * 255 / maxval;
+		    dest[x * 3 + 2] = p[2] * 255 / maxval;
+		    }
+		}
+	    }
+	}
+    free(row);
+
+    if(ok)
+	{
+	FILE *pnm = fopen("dxxtmp.pnm", "wb");
+	if(pnm)
+	    {
+	    fprintf(pnm, "P6\n%d %d\n255\n", gx, gy);
+	    fwrite(crop, 3, gx * gy, pnm);
+	    fclose(pnm);
+	    }
+	else
+	    ok = false;
+	}
+    free(crop);
+
+    return ok;
+}
+
+/// Scales down #dxxtmp.pnm# and converts it to GIF number #n#
+static void pnmToGif(int n)
+{
+    char buf[200];
+
+    sprintf(buf, "pnmscale -xscale .333 -yscale .333 dxxtmp.pnm | "
+	"pnmgamma .9 | ppmquant 256 |"
+	"ppmtogif -transparent rgb:ac/ac/ac > g%06d.gif", n);
+    _system(buf);
+}
+
+/** Converts all pages of #dxxgifs.dvi# with a single run of dvips and two
+    runs of ghostscript: one with the #bbox# device to get the bounding box
+    of every page, and one rendering all pages to a PPM stream, which is
+    cropped here page by page. Returns false if the bounding boxes could not
+    be determined, before any GIF is written, so the caller can fall back to
+    #makeGifsPerPage()#. #ok# is set to false if a page could not be cropped.
+ */
+static bool makeGifsBatched(const McDArray<int>& tog, bool& ok)
+{
+    McDArray<int> bbox;
+    char buf[200];
+    int i, x1, y1, x2, y2;
+
+    _system("dvips -q -D 600 -o dxxgifs.ps dxxgifs.dvi");
+    _system("gs -q -dNOPAUSE -dBATCH -sDEVICE=bbox dxxgifs.ps 2> dxxbbox.txt");
+
+    FILE *in = fopen("dxxbbox.txt", "r");
+    if(!in)
+	return false;
+    while(fgets(buf, 200, in))
+	if(sscanf(buf, "%%%%BoundingBox:%d %d %d %d", &x1, &y1, &x2, &y2) == 4)
+	    {
+	    bbox.append(x1);
+	    bbox.append(y1);
+	    bbox.append(x2);
+	    bbox.append(y2);
+	    }
+    fclose(in);
+    unlink("dxxbbox.txt");
+
+    if(bbox.size() != 4 * tog.size())
+	{
+#ifdef DEBUG
+	printf(_("Got %d bounding box(es) for %d page(s).\n"),
+	    bbox.size() / 4, tog.size());
+#endif
+	unlink("dxxgifs.ps");
+	return false;
+	}
+
+    sprintf(buf, "gs -q -dNOPAUSE -dBATCH -r%dx%d -sDEVICE=ppmraw -sOutputFile=- dxxgifs.ps",
+	resfac * 72, resfac * 72);
+#ifdef DEBUG
+    printf(_("Running `%s'\n"), buf);
+#endif
+#ifdef WIN32
+    FILE *pages = popen(buf, "rb");
+#else
+    FILE *pages = popen(buf, "r");
+#endif
+    if(!pages)
+	{
+	unlink("dxxgifs.ps");
+	return false;
+	}
+
+    traceProcess(buf);
+    ok = true;
+    for(i = 0; i < tog.size(); i++)
+	{
+	if(!cropPage(pages, bbox[4 * i], bbox[4 * i + 1],
+	    bbox[4 * i + 2], bbox[4 * i + 3]))
+	    {
+	    ok = false;
+	    break;
+	    }
+	pnmToGif(tog[i]);
+	}
+
+    // drain whatever is left so ghostscript does not die on a broken pipe
+    while(fread(buf, 1, 200, pages) > 0)
+	;
+    pclose(pages);
+    traceEnd();
+    unlink("dxxgifs.ps");
+
+    if(!ok)
+	fprintf(stderr, _("Warning: problems generating GIFs. Check file `dxxgifs.tex'.\n"));
+    return true;
+}
+
+/// Converts the pages of #dxxgifs.dvi# one by one
+static bool makeGifsPerPage(const McDArray<int>& tog)
+{
+    int i, x1, x2, y1, y2;
+    char buf[200];
+    char buf2[200];
+
+    for(i = 0; i < tog.size(); i++)
+	{
+	sprintf(buf, "dvips -D 600 -E -n 1 -p %d -o dxx%04d.eps dxxgifs.dvi",
+    	    i + 1, i);
+	_system(buf);
+	}
+
+    for(i = 0; i < tog.size(); i++)
+	{
+	sprintf(buf, "dxx%04d.eps", i);
+	FILE *in = fopen(buf, "r");
+	if(in)
+	    {
+	    int num = 0;
+	    while(!feof(in))
+		{
+		fgets(buf2, 200, in);
+		if(strncmp("%%BoundingBox:", buf2, 14) == 0)
+		    {
+		    num = sscanf(buf2, "%%%%BoundingBox:%d %d %d %d",
+			&x1, &y1, &x2, &y2);
+		    break;
+	            }
+		}
+	    if(num != 4)
+		fprintf(stderr, _("Couldn't extract BoundingBox "
+		    "from dxx%04d.eps.\n"), i);
+	    fclose(in);
+
+	    FILE *psfile = fopen("dxxps.ps", "w");
+
+	    fprintf(psfile,
+		".7 .7 .7 setrgbcolor newpath -1 -1 moveto %d -1 lineto %d %d "
+		"lineto -1 %d lineto closepath fill \n"
+		"-%d -%d translate "
+		"0 0 0 setrgbcolor \n (dxx%04d.eps) run",
+		x2 - x1 + 2, x2 - x1 + 2, y2 - y1 + 2, y2 - y1 + 2, x1, y1, i);
+
+	    fclose(psfile);
+
+	    int gx = (x2 - x1) * resfac;
+	    int gy = (y2 - y1) * resfac;
+
+	    gx = ((gx + 7) / 8) * 8;
+
+	    sprintf(buf, "gs -g%dx%d -r%dx%d -sDEVICE=ppmraw -sOutputFile=dxxtmp.pnm -DNOPAUSE -- dxxps.ps",
+		gx, gy, resfac * 72, resfac * 72);
+	    _system(buf);
+
+	    pnmToGif(tog[i]);
+
+	    sprintf(buf, "dxx%04d.eps", i);
+	    unlink(buf);
+	    }
+	else
+	    {
+	    fprintf(stderr, _("Warning: problems generating GIFs. Check file `dxxgifs.tex'.\n"));
+	    return false;
+            }
+	}
+
+    return true;
 }
 
 void makeGifs(const char *dir, const char *gifdb)
 {
-    NameTable gifs;
+    NameTableFile gifs;
     McDArray<int> tog;		// Table of GIFs
 
-    int i, gifNum, x1, x2, y1, y2;
+    int i;
     char buf[200];
-    char buf2[200];
-    char *olddir;
+    char *olddir = 0;
     char c;
     bool ok = true;
 
@@ -68,14 +346,18 @@ void makeGifs(const char *dir, const char *gifdb)
     printf(_("Processing file `%s'\n"), gifdb);
 #endif
 
-    std::ifstream gifFile((const char *)gifdb);
-    if(gifFile)
+    if(!gifs.open(gifdb))
 	{
-	gifFile >> gifs;
-	gifNum = gifs.num();
+	if(NameTableFile::isBinary(gifdb))
+	    fprintf(stderr, _("GIF database `%s' is damaged\n"), gifdb);
+	else
+	    // convert a GIF database in the old text format
+	    if(NameTableFile::convert(gifdb, gifdb) >= 0)
+		gifs.open(gifdb);
 	}
 
 #ifdef DEBUG
+    int gifNum = gifs.num();
     printf(_("Read %d GIF record(s).\n"), gifNum);
 #endif
 
@@ -124,15 +406,15 @@ void makeGifs(const char *dir, const char *gifdb)
 	    fprintf(stderr, _("Could not open `%s'\n"), texTitle.c_str());
 	}
 
-    for(gifs.first(); gifs.current(); gifs.next())
+    for(i = 0; i < gifs.num(); i++)
 	{
-	int n = gifs[gifs.current()];
+	int n = gifs.number(i);
 	sprintf(buf, "g%06d.gif", n);
 	FILE *exist = fopen(buf, "r");
 	if(!exist || forceGifs)
 	    {
 	    out = texfile;
-	    printYYDOC(0, gifs.current());
+	    printYYDOC(0, gifs.name(i));
 	    fprintf(texfile, "\n\n\n\\pagebreak\n\n\n");
 	    tog.append(n);
 	    }
@@ -142,74 +424,11 @@ void makeGifs(const char *dir, const char *gifdb)
     fprintf(texfile, "\\end{document}\n");
     fclose(texfile);
 
-    if((gifNum = tog.size()))
-	_system("latex dxxgifs.tex");
-
-    for(i = 0; i < gifNum; i++)
-	{
-	sprintf(buf, "dvips -D 600 -E -n 1 -p %d -o dxx%04d.eps dxxgifs.dvi",
-    	    i + 1, i);
-	_system(buf);
-	}
-
-    for(i = 0, gifs.first(); i < gifNum; i++, gifs.next())
+    if(tog.size())
 	{
-	int n = gifs[gifs.current()];
-	sprintf(buf, "dxx%04d.eps", i);
-	FILE *in = fopen(buf, "r");
-	if(in)
-	    {
-	    int num = 0;
-	    while(!feof(in))
-		{
-		fgets(buf2, 200, in);
-		if(strncmp("%%BoundingBox:", buf2, 14) == 0)
-		    {
-		    num = sscanf(buf2, "%%%%BoundingBox:%d %d %d %d",
-			&x1, &y1, &x2, &y2);
-		    break;
-	            }
-		}
-	    if(num != 4)
-		fprintf(stderr, _("Couldn't extract BoundingBox "
-		    "from dxx%04d.eps.\n"), i);
-	    fclose(in);
-
-	    FILE *psfile = fopen("dxxps.ps", "w");
-
-	    fprintf(psfile,
-		".7 .7 .7 setrgbcolor newpath -1 -1 moveto %d -1 lineto %d %d "
-		"lineto -1 %d lineto closepath fill \n"
-		"-%d -%d translate "
-		"0 0 0 setrgbcolor \n (dxx%04d.eps) run",
-		x2 - x1 + 2, x2 - x1 + 2, y2 - y1 + 2, y2 - y1 + 2, x1, y1, i);
-
-	    fclose(psfile);
-	    float resfac = 4;
-
-	    int gx = (int)((x2 - x1) * resfac);
-	    int gy = (int)((y2 - y1) * resfac);
-
-	    gx = ((gx + 7) / 8) * 8;
-
-	    sprintf(buf, "gs -g%dx%d -r%dx%d -sDEVICE=ppmraw -sOutputFile=dxxtmp.pnm -DNOPAUSE -- dxxps.ps",
-		gx, gy, (int)(resfac * 72), (int)(resfac * 72));
-	    _system(buf);
-
-	    sprintf(buf, "pnmscale -xscale .333 -yscale .333 dxxtmp.pnm | "
-		"pnmgamma .9 | ppmquant 256 |"
-		"ppmtogif -transparent rgb:ac/ac/ac > g%06d.gif", n);
-	    _system(buf);
-
-	    sprintf(buf, "dxx%04d.eps", i);
-	    unlink(buf);
-	    }
-	else
-	    {
-	    ok = false;
-	    fprintf(stderr, _("Warning: problems generating GIFs. Check file `dxxgifs.tex'.\n"));
-	    break;
-            }
+	_system("latex dxxgifs.tex");
+	if(!makeGifsBatched(tog, ok))
+	    ok = makeGifsPerPage(tog);
 	}
 
     if(ok)
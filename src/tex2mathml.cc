@@ -0,0 +1,722 @@
+/*
+  tex2mathml.cc
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this library; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include <ctype.h>
+#include <string.h>
+
+#include "McString.h"
+#include "tex2mathml.h"
+
+/// How a TeX command is translated
+enum SymbolKind
+{
+    IDENT,		// <mi>
+    OPER,		// <mo>
+    LARGEOP,		// <mo>, limits go under and over in display style
+    FUNC,		// <mi> with the name of the command
+    LIMFUNC		// like FUNC, limits go under in display style
+};
+
+struct Symbol
+{
+    const char *name;
+    SymbolKind kind;
+    const char *entity;
+};
+
+static const Symbol symbols[] =
+{
+    { "alpha", IDENT, "&#x3B1;" },
+    { "beta", IDENT, "&#x3B2;" },
+    { "gamma", IDENT, "&#x3B3;" },
+    { "delta", IDENT, "&#x3B4;" },
+    { "epsilon", IDENT, "&#x3F5;" },
+    { "varepsilon", IDENT, "&#x3B5;" },
+    { "zeta", IDENT, "&#x3B6;" },
+    { "eta", IDENT, "&#x3B7;" },
+    { "theta", IDENT, "&#x3B8;" },
+    { "vartheta", IDENT, "&#x3D1;" },
+    { "iota", IDENT, "&#x3B9;" },
+    { "kappa", IDENT, "&#x3BA;" },
+    { "lambda", IDENT, "&#x3BB;" },
+    { "mu", IDENT, "&#x3BC;" },
+    { "nu", IDENT, "&#x3BD;" },
+    { "xi", IDENT, "&#x3BE;" },
+    { "pi", IDENT, "&#x3C0;" },
+    { "varpi", IDENT, "&#x3D6;" },
+    { "rho", IDENT, "&#x3C1;" },
+    { "varrho", IDENT, "&#x3F1;" },
+    { "sigma", IDENT, "&#x3C3;" },
+    { "varsigma", IDENT, "&#x3C2;" },
+    { "tau", IDENT, "&#x3C4;" },
+    { "upsilon", IDENT, "&#x3C5;" },
+    { "phi", IDENT, "&#x3D5;" },
+    { "varphi", IDENT, "&#x3C6;" },
+    { "chi", IDENT, "&#x3C7;" },
+    { "psi", IDENT, "&#x3C8;" },
+    { "omega", IDENT, "&#x3C9;" },
+    { "Gamma", IDENT, "&#x393;" },
+    { "Delta", IDENT, "&#x394;" },
+    { "Theta", IDENT, "&#x398;" },
+    { "Lambda", IDENT, "&#x39B;" },
+    { "Xi", IDENT, "&#x39E;" },
+    { "Pi", IDENT, "&#x3A0;" },
+    { "Sigma", IDENT, "&#x3A3;" },
+    { "Upsilon", IDENT, "&#x3A5;" },
+    { "Phi", IDENT, "&#x3A6;" },
+    { "Psi", IDENT, "&#x3A8;" },
+    { "Omega", IDENT, "&#x3A9;" },
+    { "infty", IDENT, "&#x221E;" },
+    { "partial", IDENT, "&#x2202;" },
+    { "nabla", IDENT, "&#x2207;" },
+    { "ell", IDENT, "&#x2113;" },
+    { "emptyset", IDENT, "&#x2205;" },
+    { "ldots", IDENT, "&#x2026;" },
+    { "dots", IDENT, "&#x2026;" },
+    { "cdots", IDENT, "&#x22EF;" },
+    { "vdots", IDENT, "&#x22EE;" },
+    { "ddots", IDENT, "&#x22F1;" },
+    { "cdot", OPER, "&#x22C5;" },
+    { "times", OPER, "&#xD7;" },
+    { "div", OPER, "&#xF7;" },
+    { "pm", OPER, "&#xB1;" },
+    { "mp", OPER, "&#x2213;" },
+    { "ast", OPER, "&#x2217;" },
+    { "circ", OPER, "&#x2218;" },
+    { "bullet", OPER, "&#x2219;" },
+    { "oplus", OPER, "&#x2295;" },
+    { "otimes", OPER, "&#x2297;" },
+    { "le", OPER, "&#x2264;" },
+    { "leq", OPER, "&#x2264;" },
+    { "ge", OPER, "&#x2265;" },
+    { "geq", OPER, "&#x2265;" },
+    { "ne", OPER, "&#x2260;" },
+    { "neq", OPER, "&#x2260;" },
+    { "ll", OPER, "&#x226A;" },
+    { "gg", OPER, "&#x226B;" },
+    { "approx", OPER, "&#x2248;" },
+    { "equiv", OPER, "&#x2261;" },
+    { "sim", OPER, "&#x223C;" },
+    { "simeq", OPER, "&#x2243;" },
+    { "cong", OPER, "&#x2245;" },
+    { "propto", OPER, "&#x221D;" },
+    { "in", OPER, "&#x2208;" },
+    { "notin", OPER, "&#x2209;" },
+    { "ni", OPER, "&#x220B;" },
+    { "subset", OPER, "&#x2282;" },
+    { "subseteq", OPER, "&#x2286;" },
+    { "supset", OPER, "&#x2283;" },
+    { "supseteq", OPER, "&#x2287;" },
+    { "cup", OPER, "&#x222A;" },
+    { "cap", OPER, "&#x2229;" },
+    { "setminus", OPER, "&#x2216;" },
+    { "wedge", OPER, "&#x2227;" },
+    { "land", OPER, "&#x2227;" },
+    { "vee", OPER, "&#x2228;" },
+    { "lor", OPER, "&#x2228;" },
+    { "neg", OPER, "&#xAC;" },
+    { "lnot", OPER, "&#xAC;" },
+    { "forall", OPER, "&#x2200;" },
+    { "exists", OPER, "&#x2203;" },
+    { "to", OPER, "&#x2192;" },
+    { "rightarrow", OPER, "&#x2192;" },
+    { "leftarrow", OPER, "&#x2190;" },
+    { "gets", OPER, "&#x2190;" },
+    { "leftrightarrow", OPER, "&#x2194;" },
+    { "Rightarrow", OPER, "&#x21D2;" },
+    { "Leftarrow", OPER, "&#x21D0;" },
+    { "Leftrightarrow", OPER, "&#x21D4;" },
+    { "mapsto", OPER, "&#x21A6;" },
+    { "implies", OPER, "&#x27F9;" },
+    { "iff", OPER, "&#x27FA;" },
+    { "mid", OPER, "&#x2223;" },
+    { "parallel", OPER, "&#x2225;" },
+    { "perp", OPER, "&#x22A5;" },
+    { "langle", OPER, "&#x27E8;" },
+    { "rangle", OPER, "&#x27E9;" },
+    { "lfloor", OPER, "&#x230A;" },
+    { "rfloor", OPER, "&#x230B;" },
+    { "lceil", OPER, "&#x2308;" },
+    { "rceil", OPER, "&#x2309;" },
+    { "sum", LARGEOP, "&#x2211;" },
+    { "prod", LARGEOP, "&#x220F;" },
+    { "coprod", LARGEOP, "&#x2210;" },
+    { "int", LARGEOP, "&#x222B;" },
+    { "oint", LARGEOP, "&#x222E;" },
+    { "bigcup", LARGEOP, "&#x22C3;" },
+    { "bigcap", LARGEOP, "&#x22C2;" },
+    { "sin", FUNC, 0 },
+    { "cos", FUNC, 0 },
+    { "tan", FUNC, 0 },
+    { "cot", FUNC, 0 },
+    { "sec", FUNC, 0 },
+    { "csc", FUNC, 0 },
+    { "arcsin", FUNC, 0 },
+    { "arccos", FUNC, 0 },
+    { "arctan", FUNC, 0 },
+    { "sinh", FUNC, 0 },
+    { "cosh", FUNC, 0 },
+    { "tanh", FUNC, 0 },
+    { "exp", FUNC, 0 },
+    { "log", FUNC, 0 },
+    { "ln", FUNC, 0 },
+    { "lg", FUNC, 0 },
+    { "det", FUNC, 0 },
+    { "dim", FUNC, 0 },
+    { "ker", FUNC, 0 },
+    { "deg", FUNC, 0 },
+    { "gcd", FUNC, 0 },
+    { "arg", FUNC, 0 },
+    { "min", LIMFUNC, 0 },
+    { "max", LIMFUNC, 0 },
+    { "inf", LIMFUNC, 0 },
+    { "sup", LIMFUNC, 0 },
+    { "lim", LIMFUNC, 0 },
+    { "Pr", FUNC, 0 },
+    { 0, IDENT, 0 }
+};
+
+/// Accents, translated to #<mover accent="true">#
+static const Symbol accents[] =
+{
+    { "hat", OPER, "^" },
+    { "widehat", OPER, "^" },
+    { "bar", OPER, "&#xAF;" },
+    { "overline", OPER, "&#xAF;" },
+    { "vec", OPER, "&#x2192;" },
+    { "tilde", OPER, "~" },
+    { "widetilde", OPER, "~" },
+    { "dot", OPER, "&#x2D9;" },
+    { "ddot", OPER, "&#xA8;" },
+    { 0, OPER, 0 }
+};
+
+/// Spacing commands and their widths
+static const Symbol spaces[] =
+{
+    { ",", OPER, "0.167em" },
+    { ":", OPER, "0.222em" },
+    { ";", OPER, "0.278em" },
+    { " ", OPER, "0.25em" },
+    { "quad", OPER, "1em" },
+    { "qquad", OPER, "2em" },
+    { 0, OPER, 0 }
+};
+
+static const Symbol *lookup(const Symbol *table, const char *name)
+{
+    for(; table->name; table++)
+	if(strcmp(table->name, name) == 0)
+	    return table;
+    return 0;
+}
+
+class MathMLWriter
+{
+public:
+    MathMLWriter(const char *text, bool displayStyle)
+	: p(text), display(displayStyle), ok(true)
+	{
+	}
+
+    /// translate the whole formula into #out#
+    bool translate(McString& out)
+	{
+	list(out, 0);
+	skipSpace();
+	return ok && *p == 0;
+	}
+
+private:
+    const char *p;
+    bool display;
+    bool ok;
+
+    void skipSpace()
+	{
+	while(*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')
+	    p++;
+	}
+
+    void fail()
+	{
+	ok = false;
+	}
+
+    /// read a command name after `\'
+    void command(McString& name)
+	{
+	name.clear();
+	if(isalpha(*p))
+	    while(isalpha(*p))
+		name += *p++;
+	else
+	    if(*p)
+		name += *p++;
+	}
+
+    static void escaped(McString& out, char c)
+	{
+	if(c == '<')
+	    out += "&lt;";
+	else
+	    if(c == '>')
+		out += "&gt;";
+	    else
+		if(c == '&')
+		    out += "&amp;";
+		else
+		    out += c;
+	}
+
+    /// translate atoms up to #end# (or the end of the text) into #out#
+    void list(McString& out, char end)
+	{
+	McString base, sub, sup;
+	bool large;
+
+	while(ok)
+	    {
+	    skipSpace();
+	    if(*p == 0 || *p == end)
+		break;
+
+	    base.clear();
+	    large = false;
+	    if(*p == '^' || *p == '_')
+		base = "<mrow></mrow>";
+	    else
+		{
+		atom(base, large);
+		if(!ok)
+		    break;
+		if(base.length() == 0)
+		    continue;
+		}
+
+	    bool hasSub = false, hasSup = false;
+	    while(ok)
+		{
+		skipSpace();
+		if(*p == '_' && !hasSub)
+		    {
+		    p++;
+		    sub.clear();
+		    script(sub);
+		    hasSub = true;
+		    }
+		else
+		    if(*p == '^' && !hasSup)
+			{
+			p++;
+			sup.clear();
+			script(sup);
+			hasSup = true;
+			}
+		    else
+			if(*p == '\'' && !hasSup)
+			    {
+			    sup = "<mrow>";
+			    while(*p == '\'')
+				{
+				sup += "<mo>&#x2032;</mo>";
+				p++;
+				}
+			    sup += "</mrow>";
+			    hasSup = true;
+			    }
+			else
+			    break;
+		}
+
+	    // limits of big operators go under and over in display style
+	    bool limits = large && display;
+	    if(hasSub && hasSup)
+		out += limits ? "<munderover>" : "<msubsup>";
+	    else
+		if(hasSub)
+		    out += limits ? "<munder>" : "<msub>";
+		else
+		    if(hasSup)
+			out += limits ? "<mover>" : "<msup>";
+	    out += base;
+	    if(hasSub)
+		out += sub;
+	    if(hasSup)
+		out += sup;
+	    if(hasSub && hasSup)
+		out += limits ? "</munderover>" : "</msubsup>";
+	    else
+		if(hasSub)
+		    out += limits ? "</munder>" : "</msub>";
+		else
+		    if(hasSup)
+			out += limits ? "</mover>" : "</msup>";
+	    }
+	}
+
+    /// translate the argument of `^' or `_'
+    void script(McString& out)
+	{
+	bool large;
+
+	skipSpace();
+	if(*p == 0 || *p == '^' || *p == '_' || *p == '}')
+	    {
+	    fail();
+	    return;
+	    }
+	atom(out, large, true);
+	if(ok && out.length() == 0)
+	    fail();
+	}
+
+    /// translate a mandatory argument in braces (or a single atom)
+    void argument(McString& out)
+	{
+	skipSpace();
+	if(*p == '{')
+	    {
+	    p++;
+	    out += "<mrow>";
+	    list(out, '}');
+	    if(*p != '}')
+		fail();
+	    else
+		p++;
+	    out += "</mrow>";
+	    }
+	else
+	    script(out);
+	}
+
+    /// read the raw text of an argument in braces
+    void text(McString& out)
+	{
+	skipSpace();
+	if(*p != '{')
+	    {
+	    fail();
+	    return;
+	    }
+	for(p++; *p && *p != '}'; p++)
+	    if(*p == '\\' || *p == '{' || *p == '$')
+		{
+		fail();
+		return;
+		}
+	    else
+		escaped(out, *p);
+	if(*p != '}')
+	    fail();
+	else
+	    p++;
+	}
+
+    /// translate a delimiter after \left or \right
+    void delimiter(McString& out)
+	{
+	McString name;
+
+	skipSpace();
+	if(*p == '.')
+	    {
+	    p++;
+	    return;
+	    }
+	if(*p == '\\')
+	    {
+	    p++;
+	    command(name);
+	    if(name == "{" || name == "}" || name == "|")
+		{
+		out += "<mo stretchy=\"true\">";
+		out += name == "|" ? "&#x2016;" : name.c_str();
+		out += "</mo>";
+		return;
+		}
+	    const Symbol *s = lookup(symbols, name.c_str());
+	    if(!s || s->kind != OPER)
+		{
+		fail();
+		return;
+		}
+	    out += "<mo stretchy=\"true\">";
+	    out += s->entity;
+	    out += "</mo>";
+	    }
+	else
+	    if(strchr("()[]|/", *p) && *p)
+		{
+		out += "<mo stretchy=\"true\">";
+		out += *p++;
+		out += "</mo>";
+		}
+	    else
+		fail();
+	}
+
+    /** translate one atom into #out#; #large# is set for big operators.
+	A #single# atom is the operand of `^', `_' or a command without
+	braces, which is one token, so it takes only one digit.
+     */
+    void atom(McString& out, bool& large, bool single = false)
+	{
+	McString name;
+
+	large = false;
+	skipSpace();
+
+	if(isalpha(*p))
+	    {
+	    out += "<mi>";
+	    out += *p++;
+	    out += "</mi>";
+	    }
+	else
+	    if(isdigit(*p) || (!single && *p == '.' && isdigit(p[1])))
+		{
+		out += "<mn>";
+		do
+		    out += *p++;
+		while(!single && (isdigit(*p) || (*p == '.' && isdigit(p[1]))));
+		out += "</mn>";
+		}
+	    else
+		if(*p == '{')
+		    {
+		    p++;
+		    out += "<mrow>";
+		    list(out, '}');
+		    if(*p != '}')
+			fail();
+		    else
+			p++;
+		    out += "</mrow>";
+		    }
+		else
+		    if(*p == '\\')
+			{
+			p++;
+			command(name);
+			commandAtom(name, out, large);
+			}
+		    else
+			if(*p == '~')
+			    {
+			    p++;
+			    out += "<mspace width=\"0.25em\"/>";
+			    }
+			else
+			    if(*p && strchr("+-=<>()[]|,;:!/*", *p))
+				{
+				out += "<mo>";
+				if(*p == '-')
+				    out += "&#x2212;";
+				else
+				    escaped(out, *p);
+				out += "</mo>";
+				p++;
+				}
+			    else
+				// `&', `#', `%', `}' etc.
+				fail();
+	}
+
+    /// translate the command #name# (without the backslash)
+    void commandAtom(const McString& name, McString& out, bool& large)
+	{
+	const Symbol *s;
+	McString arg;
+
+	if((s = lookup(symbols, name.c_str())))
+	    {
+	    switch(s->kind)
+		{
+		case IDENT:
+		    out += "<mi>";
+		    out += s->entity;
+		    out += "</mi>";
+		    break;
+		case LARGEOP:
+		    large = true;
+		    out += "<mo largeop=\"true\">";
+		    out += s->entity;
+		    out += "</mo>";
+		    break;
+		case OPER:
+		    out += "<mo>";
+		    out += s->entity;
+		    out += "</mo>";
+		    break;
+		case LIMFUNC:
+		    large = true;
+		    // fall through
+		case FUNC:
+		    out += "<mi>";
+		    out += s->name;
+		    out += "</mi>";
+		    break;
+		}
+	    }
+	else
+	    if((s = lookup(spaces, name.c_str())))
+		{
+		out += "<mspace width=\"";
+		out += s->entity;
+		out += "\"/>";
+		}
+	    else
+		if((s = lookup(accents, name.c_str())))
+		    {
+		    out += "<mover accent=\"true\">";
+		    argument(out);
+		    out += "<mo>";
+		    out += s->entity;
+		    out += "</mo></mover>";
+		    }
+		else
+		    if(name == "frac")
+			{
+			out += "<mfrac>";
+			argument(out);
+			argument(out);
+			out += "</mfrac>";
+			}
+		    else
+			if(name == "sqrt")
+			    {
+			    skipSpace();
+			    if(*p == '[')
+				{
+				p++;
+				list(arg, ']');
+				if(*p != ']')
+				    fail();
+				else
+				    p++;
+				out += "<mroot>";
+				argument(out);
+				out += "<mrow>";
+				out += arg;
+				out += "</mrow></mroot>";
+				}
+			    else
+				{
+				out += "<msqrt>";
+				argument(out);
+				out += "</msqrt>";
+				}
+			    }
+			else
+			    if(name == "left" || name == "right")
+				delimiter(out);
+			    else
+				if(name == "mathrm" || name == "mathbf" ||
+				    name == "mathit" || name == "mathsf" ||
+				    name == "mathtt")
+				    {
+				    text(arg);
+				    out += "<mi mathvariant=\"";
+				    out += name == "mathrm" ? "normal" :
+					name == "mathbf" ? "bold" :
+					name == "mathit" ? "italic" :
+					name == "mathsf" ? "sans-serif" :
+					"monospace";
+				    out += "\">";
+				    out += arg;
+				    out += "</mi>";
+				    }
+				else
+				    if(name == "text" || name == "mbox" ||
+					name == "textrm")
+					{
+					text(arg);
+					out += "<mtext>";
+					out += arg;
+					out += "</mtext>";
+					}
+				    else
+					if(name == "{" || name == "}")
+					    {
+					    out += "<mo>";
+					    out += name;
+					    out += "</mo>";
+					    }
+					else
+					    if(name == "|")
+						out += "<mo>&#x2016;</mo>";
+					    else
+						if(name == "!")
+						    ;	// negative thin space
+						else
+						    if(name == "displaystyle")
+							display = true;
+						    else
+							fail();
+	}
+};
+
+bool texToMathML(const char *text, McString& out)
+{
+    bool display;
+    int len = strlen(text);
+    int start, end;
+    const char *env;
+
+    if(len >= 2 && text[0] == '$' && text[len - 1] == '$')
+	{
+	display = false;
+	start = 1;
+	end = len - 1;
+	}
+    else
+	if(len >= 4 && strncmp(text, "\\[", 2) == 0 &&
+	    strcmp(text + len - 2, "\\]") == 0)
+	    {
+	    display = true;
+	    start = 2;
+	    end = len - 2;
+	    }
+	else
+	    if(strncmp(text, "\\begin{equation}", 16) == 0 &&
+		(env = strstr(text, "\\end{equation")) != 0)
+		{
+		display = true;
+		start = 16;
+		end = env - text;
+		}
+	    else
+		return false;
+
+    McString body(text, start, end - start);
+    McString math;
+    MathMLWriter writer(body.c_str(), display);
+    if(!writer.translate(math))
+	return false;
+
+    out += "<math xmlns=\"http://www.w3.org/1998/Math/MathML\"";
+    if(display)
+	out += " display=\"block\"";
+    out += "><mrow>";
+    out += math;
+    out += "</mrow></math>";
+    return true;
+}
@@ -0,0 +1,33 @@
+/*
+  tex2mathml.h
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this library; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#include "McString.h"
+
+/** Translate the formula #text# to MathML and append it to #out#.
+
+    #text# is a formula as found in the documentation, including its
+    delimiters: #$...$#, #\[...\]# or an #equation# environment. Only a
+    common subset of TeX math is understood: letters, numbers and operators,
+    sub- and superscripts, groups, #\frac#, #\sqrt#, Greek letters, the usual
+    relation, arrow and big operator symbols, function names, accents and
+    spacing commands. Returns #false# and leaves #out# untouched if #text#
+    uses anything else, so the caller can fall back to a GIF.
+*/
+bool texToMathML(const char *text, McString& out);
@@ -0,0 +1,58 @@
+/*
+  yyread.h
+
+  This file is part of DOC++.
+
+  DOC++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the license, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public
+  License along with this library; if not, write to the Free
+  Software Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+#ifndef _YYREAD_H
+#define _YYREAD_H
+
+#include <string.h>
+
+/** Input of the scanners that read from a string in memory, for their
+    #YY_INPUT#. Copies the characters of #str# from #pos# on, at most
+    #max_size# of them and none from the terminating 0 on, into #buf#.
+    Advances #pos# and returns the number of characters copied, 0 at the
+    end of #str#.
+*/
+inline int yyReadString(char *buf, int max_size, const char *str, int& pos)
+{
+    const char *from = str + pos;
+    const char *end = (const char *)memchr(from, 0, max_size);
+    int n = end ? end - from : max_size;
+
+    memcpy(buf, from, n);
+    pos += n;
+    return n;
+}
+
+/** Like #yyReadString()#, but for the #length# characters at #str#, which
+    need not be followed by a 0.
+*/
+inline int yyReadSpan(char *buf, int max_size, const char *str, int length,
+    int& pos)
+{
+    int n = length - pos;
+
+    if(n > max_size)
+	n = max_size;
+    memcpy(buf, str + pos, n);
+    pos += n;
+    return n;
+}
+
+#endif